@@ -0,0 +1,130 @@
+// Local versus remote memory bandwidth per NUMA node pair, and the effect of first-touch
+// placement on a row-parallel pass over a Matrix.
+//
+// g++ -O2 -std=c++17 -pthread benchmarks/NumaBandwidth.cpp -o numa_bandwidth
+// ./numa_bandwidth [megabytes]
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/NumeriCore.hpp"
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    struct Bandwidth
+    {
+        double read = 0;
+        double write = 0;
+    };
+
+    // Runs on a thread pinned to cpu over a buffer whose pages are bound to node.
+    Bandwidth measure(size_t cpu, size_t node, size_t count)
+    {
+        Bandwidth result;
+        std::thread worker([&]() {
+            NumeriCore::Matrix::detail::pinCurrentThread(cpu);
+            std::unique_ptr<double[]> buffer(new double[count]);
+            NumeriCore::Matrix::bindMemory(buffer.get(), count * sizeof(double), NumaPolicy::Bind, node);
+
+            for (size_t i = 0; i < count; ++i) {
+                buffer[i] = 1.0; // pages are allocated here, on the bound node
+            }
+
+            constexpr int passes = 5;
+            auto start = Clock::now();
+            for (int p = 0; p < passes; ++p) {
+                for (size_t i = 0; i < count; ++i) {
+                    buffer[i] = static_cast<double>(p);
+                }
+            }
+            result.write = passes * count * sizeof(double) / seconds(start) / 1e9;
+
+            volatile double sink = 0;
+            start = Clock::now();
+            for (int p = 0; p < passes; ++p) {
+                double sum = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    sum += buffer[i];
+                }
+                sink = sink + sum;
+            }
+            result.read = passes * count * sizeof(double) / seconds(start) / 1e9;
+        });
+        worker.join();
+        return result;
+    }
+
+    // Row-parallel sum over a, repeated, in GB/s.
+    double rowPass(const Matrix<double>& a)
+    {
+        constexpr int passes = 5;
+        const size_t rows = a.getRows();
+        const size_t cols = a.getCols();
+        std::vector<double> sums(rows);
+        auto start = Clock::now();
+        for (int p = 0; p < passes; ++p) {
+            NumeriCore::Matrix::detail::parallelFor(0, rows, NumeriCore::Matrix::detail::rowBandGrainRows(),
+                [&](size_t lo, size_t hi) {
+                    for (size_t r = lo; r < hi; ++r) {
+                        const double* row = a.rowData(r);
+                        double sum = 0;
+                        for (size_t c = 0; c < cols; ++c) {
+                            sum += row[c];
+                        }
+                        sums[r] = sum;
+                    }
+                });
+        }
+        return passes * rows * cols * sizeof(double) / seconds(start) / 1e9;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const size_t count = megabytes * (1 << 20) / sizeof(double);
+    const NumaTopology& topology = numaTopology();
+    const size_t nodes = topology.getNodeCount();
+
+    std::cout << nodes << " NUMA node(s), " << megabytes << " MB per buffer\n\n";
+    std::cout << "read / write GB/s, rows: CPU node, columns: memory node\n";
+    for (size_t cpuNode = 0; cpuNode < nodes; ++cpuNode) {
+        if (topology.nodeCpus[cpuNode].empty()) {
+            continue;
+        }
+        std::cout << "node " << cpuNode << ":";
+        for (size_t memNode = 0; memNode < nodes; ++memNode) {
+            const Bandwidth b = measure(topology.nodeCpus[cpuNode].front(), memNode, count);
+            std::cout << std::fixed << std::setprecision(2) << "  " << b.read << " / " << b.write;
+        }
+        std::cout << "\n";
+    }
+
+    const size_t side = 4096;
+    setThreadPinning(true);
+    Matrix<double> firstTouch(side, side); // rows filled by the threads that read them below
+    Matrix<double> serial = firstTouch; // copied, and so touched, by the main thread alone
+    const double serialRate = rowPass(serial);
+    const double firstTouchRate = rowPass(firstTouch);
+    placeMatrix(serial, NumaPolicy::Partitioned);
+    const double placedRate = rowPass(serial);
+
+    std::cout << "\nrow-parallel pass over a " << side << "x" << side << " matrix, GB/s\n"
+        << "  serial fill:          " << serialRate << "\n"
+        << "  first-touch fill:     " << firstTouchRate << "\n"
+        << "  serial + Partitioned: " << placedRate << "\n";
+    return 0;
+}
@@ -1,7 +1,28 @@
-// #include "./headers/Vector.hpp"
-#include "./headers/Matrix/Matrix.hpp"
-#include "./headers/Matrix/DiagonalMatrix.hpp"
-
-
-// using namespace NumeriCore::Vector; 
+// #include "./headers/Vector.hpp"
+#include "./headers/Matrix/Matrix.hpp"
+#include "./headers/Matrix/DiagonalMatrix.hpp"
+#include "./headers/Matrix/SymmetricMatrix.hpp"
+#include "./headers/Matrix/TriangularMatrix.hpp"
+#include "./headers/Matrix/Strassen.hpp"
+#include "./headers/Matrix/Cholesky.hpp"
+#include "./headers/Matrix/LU.hpp"
+#include "./headers/Matrix/Woodbury.hpp"
+#include "./headers/Matrix/HouseholderQR.hpp"
+#include "./headers/Matrix/Krylov.hpp"
+#include "./headers/Matrix/TaskGraph.hpp"
+#include "./headers/Matrix/Numa.hpp"
+#include "./headers/Matrix/Reductions.hpp"
+#include "./headers/Matrix/MatrixChain.hpp"
+#include "./headers/Matrix/Gemm.hpp"
+#include "./headers/Matrix/SharedMatrix.hpp"
+#include "./headers/Matrix/Broadcast.hpp"
+#include "./headers/Matrix/Complex.hpp"
+#include "./headers/Matrix/Convolution.hpp"
+#include "./headers/Matrix/Streaming.hpp"
+#include "./headers/Matrix/Spectral.hpp"
+#include "./headers/Matrix/Autotune.hpp"
+#include "./headers/Matrix/ResultCache.hpp"
+
+
+// using namespace NumeriCore::Vector; 
 using namespace NumeriCore::Matrix; 
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef __AUTOTUNE_HPP__
+#define __AUTOTUNE_HPP__
+
+#include <vector>
+#include <chrono>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <initializer_list>
+
+#include "Matrix.hpp"
+#include "Tuning.hpp"
+#include "Gemm.hpp"
+#include "Broadcast.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+        * @brief Problem sizes and behaviour of autotune().
+        * The sizes should resemble the workload: the GEMM blocking is timed on a square product,
+        * the GEMM thread cutoff on a product with few rows, the elementwise cutoff on a matrix that
+        * is neither tiny nor huge, where the serial / parallel decision matters.
+        */
+        struct AutotuneOptions
+        {
+            size_t gemmSize = 384;          // n of the n x n x n product timed for the blocking
+            size_t gemmSmallRows = 96;      // rows of the product timed for gemmGrainRows
+            size_t transposeSize = 2048;    // n of the n x n transpose
+            size_t elementwiseRows = 512;   // shape of the broadcast timed for elementwiseGrain
+            size_t elementwiseCols = 512;
+            size_t repetitions = 3;         // every candidate keeps its best of this many runs
+            bool save = true;               // store the winners with saveTuning()
+            std::string path = defaultTuningPath();
+        };
+
+
+        namespace detail
+        {
+            template<class F>
+            double bestSeconds(size_t repetitions, F&& f)
+            {
+                double best = std::numeric_limits<double>::max();
+                for (size_t r = 0; r < std::max<size_t>(repetitions, 1); ++r) {
+                    const auto start = std::chrono::steady_clock::now();
+                    f();
+                    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    best = std::min(best, elapsed.count());
+                }
+                return best;
+            }
+
+            /**
+            * @brief Sets field of the current parameters to every candidate in turn, keeps the
+            * fastest by run() and leaves it set.
+            */
+
+            template<class F>
+            void sweep(size_t TuningParameters::* field, std::initializer_list<size_t> candidates, size_t repetitions, F&& run)
+            {
+                TuningParameters best = getTuning();
+                double bestTime = std::numeric_limits<double>::max();
+                for (size_t candidate : candidates) {
+                    TuningParameters trial = best;
+                    trial.*field = candidate;
+                    setTuning(trial);
+                    run(); // warm up caches and page in the buffers
+                    const double time = bestSeconds(repetitions, run);
+                    if (time < bestTime) {
+                        bestTime = time;
+                        best = trial;
+                    }
+                }
+                setTuning(best);
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Benchmarks candidate blocking factors and cutoffs on this machine, applies the
+        * fastest and, unless disabled, stores them in the tuning file under machineKey().
+        * Every later process on a machine with the same CPU model, caches and thread count loads
+        * them before its first kernel, so a mixed fleet runs each host at its own best settings.
+        *
+        * The GEMM block shape is tuned one dimension at a time (cols, inner, rows, then cols
+        * again with the others fixed), followed by the GEMM row cutoff, the transpose tile and the
+        * elementwise cutoff. Timings use double. A run takes a few seconds with the default
+        * options; the parameters change globally while it runs, so run it on an idle process.
+        *
+        * Example usage:
+        * \code
+        * // once per host, e.g. from an install script
+        * NumeriCore::Matrix::TuningParameters best = NumeriCore::Matrix::autotune();
+        * \endcode
+        *
+        * @param options Problem sizes, repetitions and where to save.
+        * @return The parameters now in effect.
+        * @throws std::runtime_error if saving was requested and the file cannot be written.
+        */
+
+        inline TuningParameters autotune(const AutotuneOptions& options = AutotuneOptions())
+        {
+            const size_t reps = options.repetitions;
+            const TuningParameters previous = getTuning();
+            try {
+                {
+                    const size_t n = std::max<size_t>(options.gemmSize, 1);
+                    const Matrix<double> a(n, n);
+                    const Matrix<double> b(n, n);
+                    Matrix<double> c(n, n, zeroFill);
+                    auto run = [&]() { gemm(1.0, a, b, 0.0, c); };
+                    detail::sweep(&TuningParameters::gemmBlockCols, { 64, 128, 256, 512 }, reps, run);
+                    detail::sweep(&TuningParameters::gemmBlockInner, { 64, 128, 256, 512 }, reps, run);
+                    detail::sweep(&TuningParameters::gemmBlockRows, { 16, 32, 64, 128 }, reps, run);
+                    detail::sweep(&TuningParameters::gemmBlockCols, { 64, 128, 256, 512 }, reps, run);
+
+                    const Matrix<double> small(std::max<size_t>(options.gemmSmallRows, 1), n);
+                    Matrix<double> out(small.getRows(), n);
+                    detail::sweep(&TuningParameters::gemmGrainRows, { 8, 16, 32, 64, 128 }, reps, [&]() {
+                        gemm(1.0, small, b, 0.0, out);
+                    });
+                }
+                {
+                    const size_t n = std::max<size_t>(options.transposeSize, 1);
+                    Matrix<double> m(n, n);
+                    detail::sweep(&TuningParameters::transposeTile, { 8, 16, 32, 64, 128 }, reps, [&]() {
+                        m.transpose();
+                    });
+                }
+                {
+                    Matrix<double> m(std::max<size_t>(options.elementwiseRows, 1), std::max<size_t>(options.elementwiseCols, 1));
+                    const RowVector<double> v{ std::vector<double>(m.getCols(), 1.0) };
+                    detail::sweep(&TuningParameters::elementwiseGrain, { 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20 }, reps, [&]() {
+                        m += v;
+                    });
+                }
+            }
+            catch (...) {
+                setTuning(previous);
+                throw;
+            }
+
+            if (options.save) {
+                saveTuning(options.path);
+            }
+            return getTuning();
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __AUTOTUNE_HPP__ */
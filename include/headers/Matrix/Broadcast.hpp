@@ -0,0 +1,222 @@
+#ifndef __BROADCAST_HPP__
+#define __BROADCAST_HPP__
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Parallel.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Row and column broadcasting
+        //
+        // A RowVector holds one value per column and is applied to every row, a ColumnVector holds
+        // one value per row and is applied to every column. The vector is never expanded to the
+        // size of the matrix: each row is updated in one contiguous pass while the row vector (a
+        // few KB) stays in L1, rows are split over threads by detail::parallelFor.
+        //
+        // Example usage:
+        // \code
+        // m += NumeriCore::Matrix::RowVector<double>{ bias };       // m(i, j) += bias[j]
+        // m /= NumeriCore::Matrix::ColumnVector<double>{ norms };   // m(i, j) /= norms[i]
+        // \endcode
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Values broadcast along the rows, values[col] is applied to every element of a column.
+        */
+        template<class T>
+        struct RowVector
+        {
+            std::vector<T> values;
+        };
+
+        /**
+        * @brief Values broadcast along the columns, values[row] is applied to every element of a row.
+        */
+        template<class T>
+        struct ColumnVector
+        {
+            std::vector<T> values;
+        };
+
+
+        namespace detail
+        {
+            /**
+            * @brief m(i, j) = op(m(i, j), v[j]) in place.
+            * The inner loop walks a row and the vector side by side, both contiguous, so it
+            * vectorizes for the arithmetic operators.
+            */
+
+            template<class T, class Op>
+            void broadcastRow(Matrix<T>& m, const std::vector<T>& v, Op op)
+            {
+                if (v.size() != m.getCols()) {
+                    throw std::invalid_argument("Row vector size must match the number of columns.");
+                }
+                const auto rows = m.rows().begin(); // marks m modified once, before the threads start
+                const size_t cols = m.getCols();
+                const T* values = v.data();
+                detail::parallelFor(0, m.getRows(), detail::elementwiseGrainRows(cols), [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        T* row = rows[i].data();
+                        for (size_t j = 0; j < cols; ++j) {
+                            row[j] = op(row[j], values[j]);
+                        }
+                    }
+                });
+            }
+
+            /**
+            * @brief m(i, j) = op(m(i, j), v[i]) in place, one scalar per row.
+            */
+
+            template<class T, class Op>
+            void broadcastColumn(Matrix<T>& m, const std::vector<T>& v, Op op)
+            {
+                if (v.size() != m.getRows()) {
+                    throw std::invalid_argument("Column vector size must match the number of rows.");
+                }
+                const auto rows = m.rows().begin();
+                const size_t cols = m.getCols();
+                detail::parallelFor(0, m.getRows(), detail::elementwiseGrainRows(cols), [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        T* row = rows[i].data();
+                        const T value = v[i];
+                        for (size_t j = 0; j < cols; ++j) {
+                            row[j] = op(row[j], value);
+                        }
+                    }
+                });
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // In-place broadcasting operators
+        //
+        // @throws std::invalid_argument if the vector size does not match the broadcast dimension.
+        // Division follows the arithmetic of T, a zero divisor is not checked.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        Matrix<T>& operator+=(Matrix<T>& m, const RowVector<T>& v)
+        {
+            detail::broadcastRow(m, v.values, std::plus<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator-=(Matrix<T>& m, const RowVector<T>& v)
+        {
+            detail::broadcastRow(m, v.values, std::minus<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator*=(Matrix<T>& m, const RowVector<T>& v)
+        {
+            detail::broadcastRow(m, v.values, std::multiplies<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator/=(Matrix<T>& m, const RowVector<T>& v)
+        {
+            detail::broadcastRow(m, v.values, std::divides<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator+=(Matrix<T>& m, const ColumnVector<T>& v)
+        {
+            detail::broadcastColumn(m, v.values, std::plus<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator-=(Matrix<T>& m, const ColumnVector<T>& v)
+        {
+            detail::broadcastColumn(m, v.values, std::minus<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator*=(Matrix<T>& m, const ColumnVector<T>& v)
+        {
+            detail::broadcastColumn(m, v.values, std::multiplies<T>());
+            return m;
+        }
+
+        template<class T>
+        Matrix<T>& operator/=(Matrix<T>& m, const ColumnVector<T>& v)
+        {
+            detail::broadcastColumn(m, v.values, std::divides<T>());
+            return m;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Broadcasting operators returning a new matrix, a copy of m updated in place
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        Matrix<T> operator+(Matrix<T> m, const RowVector<T>& v)
+        {
+            return std::move(m += v);
+        }
+
+        template<class T>
+        Matrix<T> operator-(Matrix<T> m, const RowVector<T>& v)
+        {
+            return std::move(m -= v);
+        }
+
+        template<class T>
+        Matrix<T> operator*(Matrix<T> m, const RowVector<T>& v)
+        {
+            return std::move(m *= v);
+        }
+
+        template<class T>
+        Matrix<T> operator/(Matrix<T> m, const RowVector<T>& v)
+        {
+            return std::move(m /= v);
+        }
+
+        template<class T>
+        Matrix<T> operator+(Matrix<T> m, const ColumnVector<T>& v)
+        {
+            return std::move(m += v);
+        }
+
+        template<class T>
+        Matrix<T> operator-(Matrix<T> m, const ColumnVector<T>& v)
+        {
+            return std::move(m -= v);
+        }
+
+        template<class T>
+        Matrix<T> operator*(Matrix<T> m, const ColumnVector<T>& v)
+        {
+            return std::move(m *= v);
+        }
+
+        template<class T>
+        Matrix<T> operator/(Matrix<T> m, const ColumnVector<T>& v)
+        {
+            return std::move(m /= v);
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __BROADCAST_HPP__ */
@@ -0,0 +1,312 @@
+#ifndef __CHOLESKY_HPP__
+#define __CHOLESKY_HPP__
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "SymmetricMatrix.hpp"
+#include "TriangularMatrix.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Cholesky factorization A = L * L^T of a symmetric positive definite matrix.
+         * The factor is computed once by a blocked right-looking algorithm and kept in packed
+         * storage, so any number of right-hand sides can be solved afterwards in O(n^2) each.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::Cholesky<double> chol(covariance);
+         * auto x = chol.solve(b);
+         * double logDet = chol.logDeterminant();
+         * \endcode
+         */
+        template<class T>
+        class Cholesky
+        {
+        public:
+            explicit Cholesky(const Matrix<T>& a, size_t blockSize = 64); // reads the lower triangle of a
+            explicit Cholesky(const SymmetricMatrix<T>& a, size_t blockSize = 64);
+
+            ~Cholesky() = default;
+
+        public:
+            Matrix<T> solve(const Matrix<T>& b) const; // solve A * x = b
+            TriangularMatrix<T> getL() const; // lower triangular factor
+            T logDeterminant() const; // log(det(A))
+            size_t getSize() const; // order of A
+
+            void update(const Matrix<T>& x); // factor A + x * x^T instead
+            void downdate(const Matrix<T>& x); // factor A - x * x^T instead
+
+        private:
+            void factorize(std::vector<T>& a, size_t blockSize);
+            void rankOne(std::vector<T>& x, bool subtract);
+            void rankK(const Matrix<T>& x, bool subtract);
+
+        private:
+            size_t m_size = 0;
+            std::vector<T> m_factor; // L packed row by row
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Cholesky class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Factorizes a dense symmetric positive definite matrix.
+         * @param a The matrix, only its lower triangle is read.
+         * @param blockSize Order of the diagonal blocks, the trailing updates run as GEMM calls of this depth.
+         * @throw std::invalid_argument If a is not square.
+         * @throw std::runtime_error If a is not positive definite.
+         * @tparam T Type of matrix elements.
+         */
+
+        template<class T>
+        Cholesky<T>::Cholesky(const Matrix<T>& a, size_t blockSize)
+            : m_size(a.getRows())
+        {
+            if (a.getRows() != a.getCols()) {
+                throw std::invalid_argument("Cholesky factorization requires a square matrix!");
+            }
+            std::vector<T> dense = detail::pack(a);
+            factorize(dense, blockSize);
+        }
+
+        template<class T>
+        Cholesky<T>::Cholesky(const SymmetricMatrix<T>& a, size_t blockSize)
+            : m_size(a.getRows())
+        {
+            const std::vector<T>& packed = a.getPacked();
+            std::vector<T> dense(m_size * m_size, static_cast<T>(0));
+            for (size_t i = 0; i < m_size; ++i) {
+                std::copy(packed.begin() + i * (i + 1) / 2, packed.begin() + i * (i + 1) / 2 + i + 1, dense.begin() + i * m_size);
+            }
+            factorize(dense, blockSize);
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Cholesky class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Blocked right-looking factorization of the row-major matrix in a.
+         * Per block column: unblocked factorization of the diagonal block, TRSM of the panel below it
+         * and a GEMM update of the lower trapezoid of the trailing matrix. Panel and trailing update
+         * are split over row blocks and run in parallel.
+         */
+
+        template<class T>
+        void Cholesky<T>::factorize(std::vector<T>& a, size_t blockSize)
+        {
+            const size_t n = m_size;
+            const size_t nb = std::max<size_t>(blockSize, 1);
+            T* A = a.data();
+            std::vector<T> w;
+            const TuningParameters tuning = detail::currentTuning();
+
+            for (size_t k = 0; k < n; k += nb) {
+                const size_t kb = std::min(nb, n - k);
+
+                for (size_t j = k; j < k + kb; ++j) {
+                    T* aj = A + j * n;
+                    T d = aj[j];
+                    for (size_t p = k; p < j; ++p) {
+                        d -= aj[p] * aj[p];
+                    }
+                    if (!(d > static_cast<T>(0))) {
+                        throw std::runtime_error("Matrix is not positive definite.");
+                    }
+                    aj[j] = std::sqrt(d);
+                    for (size_t i = j + 1; i < k + kb; ++i) {
+                        T* ai = A + i * n;
+                        T sum = ai[j];
+                        for (size_t p = k; p < j; ++p) {
+                            sum -= ai[p] * aj[p];
+                        }
+                        ai[j] = sum / aj[j];
+                    }
+                }
+
+                const size_t m = n - k - kb;
+                if (m == 0) {
+                    break;
+                }
+                T* L21 = A + (k + kb) * n + k;
+                T* A22 = A + (k + kb) * n + (k + kb);
+
+                // L21 = A21 * L11^-T
+                detail::parallelFor(0, m, tuning.gemmGrainRows, [&](size_t lo, size_t hi) {
+                    detail::trsmRightTransposed(true, false, hi - lo, kb, detail::DenseRows<const T>{ A + k * n + k, n }, L21 + lo * n, n);
+                });
+
+                // A22 -= L21 * L21^T, only the lower trapezoid of every row block
+                w.assign(kb * m, static_cast<T>(0));
+                for (size_t i = 0; i < m; ++i) {
+                    for (size_t p = 0; p < kb; ++p) {
+                        w[p * m + i] = -L21[i * n + p];
+                    }
+                }
+                detail::parallelFor(0, m, tuning.gemmGrainRows, [&](size_t lo, size_t hi) {
+                    for (size_t ib = lo; ib < hi; ib += tuning.gemmBlockRows) {
+                        const size_t ie = std::min(ib + tuning.gemmBlockRows, hi);
+                        detail::gemm(ie - ib, ie, kb, L21 + ib * n, n, w.data(), m, A22 + ib * n, n, true);
+                    }
+                });
+            }
+
+            m_factor.resize(detail::packedSize(n));
+            for (size_t i = 0; i < n; ++i) {
+                std::copy(A + i * n, A + i * n + i + 1, m_factor.begin() + i * (i + 1) / 2);
+            }
+        }
+
+
+        /**
+        * @brief Solves A * x = b with two triangular solves, L * y = b and L^T * x = y.
+        * Columns of b are independent and are solved in parallel.
+        * @param b Right-hand sides, one per column.
+        * @throws std::invalid_argument if b has the wrong number of rows.
+        * @return The solution x.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline Matrix<T> Cholesky<T>::solve(const Matrix<T>& b) const
+        {
+            if (b.getRows() != m_size) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the factorized matrix.");
+            }
+            const size_t r = b.getCols();
+            std::vector<T> x = detail::pack(b);
+            const detail::PackedLowerRows<const T> rows{ m_factor.data() };
+
+            detail::parallelFor(0, r, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::trsmLeft(true, false, m_size, hi - lo, rows, x.data() + lo, r);
+                detail::trsmLeftTransposed(true, false, m_size, hi - lo, rows, x.data() + lo, r);
+            });
+
+            Matrix<T> result(b.getRows(), r, zeroFill);
+            detail::unpack(x.data(), r, result);
+            return result;
+        }
+
+        template<class T>
+        inline TriangularMatrix<T> Cholesky<T>::getL() const
+        {
+            TriangularMatrix<T> result(m_size, Triangle::Lower, false, "CholeskyFactor");
+            for (size_t i = 0; i < m_size; ++i) {
+                for (size_t j = 0; j <= i; ++j) {
+                    result.setElement(i, j, m_factor[i * (i + 1) / 2 + j]);
+                }
+            }
+            return result;
+        }
+
+        template<class T>
+        inline T Cholesky<T>::logDeterminant() const
+        {
+            T result = static_cast<T>(0);
+            for (size_t i = 0; i < m_size; ++i) {
+                result += std::log(m_factor[i * (i + 1) / 2 + i]);
+            }
+            return static_cast<T>(2) * result;
+        }
+
+        template<class T>
+        inline size_t Cholesky<T>::getSize() const
+        {
+            return m_size;
+        }
+
+        /**
+        * @brief Rank-1 modification L * L^T +/- x * x^T in O(n^2).
+        * Column k is rotated against x (hyperbolically for a downdate):
+        *      r = sqrt(l_kk^2 +/- x_k^2), c = r / l_kk, s = x_k / l_kk
+        *      l_ik = (l_ik +/- s x_i) / c,   x_i = c x_i - s l_ik   for i > k
+        * @throws std::runtime_error if a downdate loses positive definiteness, the factor is partly
+        * modified then.
+        */
+
+        template<class T>
+        void Cholesky<T>::rankOne(std::vector<T>& x, bool subtract)
+        {
+            const T sign = subtract ? static_cast<T>(-1) : static_cast<T>(1);
+            for (size_t k = 0; k < m_size; ++k) {
+                T& lkk = m_factor[k * (k + 1) / 2 + k];
+                const T squared = lkk * lkk + sign * x[k] * x[k];
+                if (!(squared > static_cast<T>(0))) {
+                    throw std::runtime_error("Downdate makes the matrix indefinite.");
+                }
+                const T r = std::sqrt(squared);
+                const T c = r / lkk;
+                const T s = x[k] / lkk;
+                lkk = r;
+                for (size_t i = k + 1; i < m_size; ++i) {
+                    T& lik = m_factor[i * (i + 1) / 2 + k];
+                    lik = (lik + sign * s * x[i]) / c;
+                    x[i] = c * x[i] - s * lik;
+                }
+            }
+        }
+
+        template<class T>
+        void Cholesky<T>::rankK(const Matrix<T>& x, bool subtract)
+        {
+            if (x.getRows() != m_size) {
+                throw std::invalid_argument("Update vectors must have one row per row of the factorized matrix.");
+            }
+            const std::vector<T> saved = subtract ? m_factor : std::vector<T>();
+            std::vector<T> column(m_size);
+            try {
+                for (size_t c = 0; c < x.getCols(); ++c) {
+                    for (size_t i = 0; i < m_size; ++i) {
+                        column[i] = x.rowData(i)[c];
+                    }
+                    rankOne(column, subtract);
+                }
+            }
+            catch (...) {
+                m_factor = saved;
+                throw;
+            }
+        }
+
+        /**
+        * @brief Replaces the factorization of A by one of A + x * x^T, O(n^2 k) for k columns.
+        * @param x Update vectors, n x k.
+        * @throws std::invalid_argument if x has the wrong number of rows.
+        */
+
+        template<class T>
+        inline void Cholesky<T>::update(const Matrix<T>& x)
+        {
+            rankK(x, false);
+        }
+
+        /**
+        * @brief Replaces the factorization of A by one of A - x * x^T, O(n^2 k) for k columns.
+        * @param x Downdate vectors, n x k.
+        * @throws std::invalid_argument if x has the wrong number of rows.
+        * @throws std::runtime_error if A - x * x^T is not positive definite, the factorization of A
+        * is kept then.
+        */
+
+        template<class T>
+        inline void Cholesky<T>::downdate(const Matrix<T>& x)
+        {
+            rankK(x, true);
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __CHOLESKY_HPP__ */
@@ -0,0 +1,605 @@
+#ifndef __COMPLEX_HPP__
+#define __COMPLEX_HPP__
+
+#include <vector>
+#include <complex>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Complex matrices
+        //
+        // Matrix<std::complex<R>> is the interleaved layout, re and im of an element are adjacent
+        // (std::complex<R> is layout compatible with R[2]). SplitComplexMatrix<R> keeps all real
+        // parts in one plane and all imaginary parts in another, so elementwise loops and the real
+        // GEMM kernel run on plain R arrays. Interleaved suits element access and interop, split
+        // suits long chains of arithmetic; converting between them is one pass.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        namespace detail
+        {
+            template<class T>
+            struct IsComplex : std::false_type {};
+
+            template<class R>
+            struct IsComplex<std::complex<R>> : std::true_type {};
+
+            // conj(x) that stays in T, std::conj of a real number returns a std::complex.
+            template<class T>
+            inline T conjugateOf(const T& x)
+            {
+                if constexpr (IsComplex<T>::value) {
+                    return std::conj(x);
+                }
+                else {
+                    return x;
+                }
+            }
+
+            // The real and imaginary parts of a row of complex numbers, [re0, im0, re1, im1, ...].
+            template<class R>
+            inline const R* interleaved(const std::complex<R>* row)
+            {
+                return reinterpret_cast<const R*>(row);
+            }
+
+            template<class R>
+            inline R* interleaved(std::complex<R>* row)
+            {
+                return reinterpret_cast<R*>(row);
+            }
+
+        }; // end namespace detail
+
+
+        /**
+         * @brief Conjugate transpose A^H of a matrix, viewed without copying.
+         * Element (i, j) is conj(A(j, i)). Products taking a view read the operand directly, for
+         * anything else convert to a Matrix. For real T this is the plain transpose. The view
+         * holds a pointer to the matrix, which must outlive it.
+         *
+         * Example usage:
+         * \code
+         * auto gram = NumeriCore::Matrix::multiply3m(adjoint(a), a);  // A^H * A
+         * NumeriCore::Matrix::Matrix<std::complex<double>> ah = adjoint(a);
+         * \endcode
+         */
+        template<class T>
+        class ConjugateTranspose
+        {
+        public:
+            explicit ConjugateTranspose(const Matrix<T>& m) : m_matrix(&m) {}
+
+            T getElement(size_t row, size_t col) const; // conj(A(col, row))
+            size_t getRows() const { return m_matrix->getCols(); }
+            size_t getCols() const { return m_matrix->getRows(); }
+            const Matrix<T>& base() const { return *m_matrix; } // the matrix A itself
+
+            operator Matrix<T>() const; // materializes A^H
+
+        private:
+            const Matrix<T>* m_matrix;
+        };
+
+        template<class T>
+        ConjugateTranspose<T> adjoint(const Matrix<T>& m)
+        {
+            return ConjugateTranspose<T>(m);
+        }
+
+        // A^H^H is A.
+        template<class T>
+        const Matrix<T>& adjoint(const ConjugateTranspose<T>& view)
+        {
+            return view.base();
+        }
+
+
+        /**
+         * @brief Complex matrix in split storage: one contiguous, row-major plane of real parts
+         * and one of imaginary parts.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::SplitComplexMatrix<float> x(signal);  // from Matrix<std::complex<float>>
+         * x.hadamard(window);
+         * auto y = NumeriCore::Matrix::multiply3m(filter, x).toInterleaved();
+         * \endcode
+         */
+        template<class R>
+        class SplitComplexMatrix
+        {
+        public:
+            SplitComplexMatrix() = default;
+            SplitComplexMatrix(size_t rows, size_t cols); // zero matrix
+            explicit SplitComplexMatrix(const Matrix<std::complex<R>>& m); // from interleaved storage
+            explicit SplitComplexMatrix(const ConjugateTranspose<std::complex<R>>& view); // materializes A^H
+
+            ~SplitComplexMatrix() = default;
+
+        public:
+            Matrix<std::complex<R>> toInterleaved() const;
+
+            std::complex<R> getElement(size_t row, size_t col) const; // checked like Matrix::at()
+            void setElement(size_t row, size_t col, const std::complex<R>& value);
+            size_t getRows() const;
+            size_t getCols() const;
+
+            R* real(); // real plane, element (i, j) at i * getCols() + j
+            const R* real() const;
+            R* imag(); // imaginary plane, same layout
+            const R* imag() const;
+
+            SplitComplexMatrix& operator +=(const SplitComplexMatrix& other);
+            SplitComplexMatrix& operator -=(const SplitComplexMatrix& other);
+            SplitComplexMatrix& operator *=(const std::complex<R>& scalar);
+            SplitComplexMatrix& hadamard(const SplitComplexMatrix& other); // elementwise product
+            SplitComplexMatrix& conjugate(); // negates the imaginary plane
+
+            template<class U>
+            friend std::ostream& operator<<(std::ostream& os, const SplitComplexMatrix<U>& m);
+
+        private:
+            void checkSameShape(const SplitComplexMatrix& other) const;
+
+        private:
+            size_t m_rows = 0;
+            size_t m_cols = 0;
+            std::vector<R> m_real;
+            std::vector<R> m_imag;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // ConjugateTranspose class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        T ConjugateTranspose<T>::getElement(size_t row, size_t col) const
+        {
+            return detail::conjugateOf(m_matrix->getElement(col, row));
+        }
+
+        /**
+        * @brief Writes A^H in square tiles so both the rows read and the rows written stay in cache.
+        */
+
+        template<class T>
+        ConjugateTranspose<T>::operator Matrix<T>() const
+        {
+            const size_t rows = getRows();
+            const size_t cols = getCols();
+            Matrix<T> result(rows, cols, zeroFill);
+            const size_t tile = detail::currentTuning().transposeTile;
+            detail::parallelFor(0, rows, tile, [&](size_t lo, size_t hi) {
+                for (size_t jj = 0; jj < cols; jj += tile) {
+                    const size_t jEnd = std::min(jj + tile, cols);
+                    for (size_t i = lo; i < hi; ++i) {
+                        T* out = result.rowData(i);
+                        for (size_t j = jj; j < jEnd; ++j) {
+                            out[j] = detail::conjugateOf(m_matrix->rowData(j)[i]);
+                        }
+                    }
+                }
+            });
+            return result;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SplitComplexMatrix class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class R>
+        SplitComplexMatrix<R>::SplitComplexMatrix(size_t rows, size_t cols)
+            : m_rows(rows)
+            , m_cols(cols)
+            , m_real(rows * cols, static_cast<R>(0))
+            , m_imag(rows * cols, static_cast<R>(0))
+        {
+        }
+
+        template<class R>
+        SplitComplexMatrix<R>::SplitComplexMatrix(const Matrix<std::complex<R>>& m)
+            : SplitComplexMatrix(m.getRows(), m.getCols())
+        {
+            detail::parallelFor(0, m_rows, detail::elementwiseGrainRows(m_cols), [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    const R* in = detail::interleaved(m.rowData(i));
+                    R* re = m_real.data() + i * m_cols;
+                    R* im = m_imag.data() + i * m_cols;
+                    for (size_t j = 0; j < m_cols; ++j) {
+                        re[j] = in[2 * j];
+                        im[j] = in[2 * j + 1];
+                    }
+                }
+            });
+        }
+
+        template<class R>
+        SplitComplexMatrix<R>::SplitComplexMatrix(const ConjugateTranspose<std::complex<R>>& view)
+            : SplitComplexMatrix(view.getRows(), view.getCols())
+        {
+            const Matrix<std::complex<R>>& a = view.base();
+            const size_t tile = detail::currentTuning().transposeTile;
+            detail::parallelFor(0, m_rows, tile, [&](size_t lo, size_t hi) {
+                for (size_t jj = 0; jj < m_cols; jj += tile) {
+                    const size_t jEnd = std::min(jj + tile, m_cols);
+                    for (size_t i = lo; i < hi; ++i) {
+                        R* re = m_real.data() + i * m_cols;
+                        R* im = m_imag.data() + i * m_cols;
+                        for (size_t j = jj; j < jEnd; ++j) {
+                            const std::complex<R>& value = a.rowData(j)[i];
+                            re[j] = value.real();
+                            im[j] = -value.imag();
+                        }
+                    }
+                }
+            });
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SplitComplexMatrix class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class R>
+        Matrix<std::complex<R>> SplitComplexMatrix<R>::toInterleaved() const
+        {
+            Matrix<std::complex<R>> result(m_rows, m_cols, zeroFill);
+            detail::parallelFor(0, m_rows, detail::elementwiseGrainRows(m_cols), [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    R* out = detail::interleaved(result.rowData(i));
+                    const R* re = m_real.data() + i * m_cols;
+                    const R* im = m_imag.data() + i * m_cols;
+                    for (size_t j = 0; j < m_cols; ++j) {
+                        out[2 * j] = re[j];
+                        out[2 * j + 1] = im[j];
+                    }
+                }
+            });
+            return result;
+        }
+
+        /**
+        * @throws std::out_of_range if the index is outside the matrix.
+        */
+
+        template<class R>
+        std::complex<R> SplitComplexMatrix<R>::getElement(size_t row, size_t col) const
+        {
+            if (row >= m_rows || col >= m_cols) {
+                throw std::out_of_range("Index out of range.");
+            }
+            return { m_real[row * m_cols + col], m_imag[row * m_cols + col] };
+        }
+
+        /**
+        * @throws std::out_of_range if the index is outside the matrix.
+        */
+
+        template<class R>
+        void SplitComplexMatrix<R>::setElement(size_t row, size_t col, const std::complex<R>& value)
+        {
+            if (row >= m_rows || col >= m_cols) {
+                throw std::out_of_range("Index out of range.");
+            }
+            m_real[row * m_cols + col] = value.real();
+            m_imag[row * m_cols + col] = value.imag();
+        }
+
+        template<class R>
+        size_t SplitComplexMatrix<R>::getRows() const
+        {
+            return m_rows;
+        }
+
+        template<class R>
+        size_t SplitComplexMatrix<R>::getCols() const
+        {
+            return m_cols;
+        }
+
+        template<class R>
+        R* SplitComplexMatrix<R>::real()
+        {
+            return m_real.data();
+        }
+
+        template<class R>
+        const R* SplitComplexMatrix<R>::real() const
+        {
+            return m_real.data();
+        }
+
+        template<class R>
+        R* SplitComplexMatrix<R>::imag()
+        {
+            return m_imag.data();
+        }
+
+        template<class R>
+        const R* SplitComplexMatrix<R>::imag() const
+        {
+            return m_imag.data();
+        }
+
+        template<class R>
+        void SplitComplexMatrix<R>::checkSameShape(const SplitComplexMatrix& other) const
+        {
+            if (m_rows != other.m_rows || m_cols != other.m_cols) {
+                throw std::invalid_argument("Matrices must have the same dimensions.");
+            }
+        }
+
+        /**
+        * @throws std::invalid_argument if matrices have different dimensions.
+        */
+
+        template<class R>
+        SplitComplexMatrix<R>& SplitComplexMatrix<R>::operator+=(const SplitComplexMatrix& other)
+        {
+            checkSameShape(other);
+            for (size_t i = 0; i < m_real.size(); ++i) {
+                m_real[i] += other.m_real[i];
+                m_imag[i] += other.m_imag[i];
+            }
+            return *this;
+        }
+
+        /**
+        * @throws std::invalid_argument if matrices have different dimensions.
+        */
+
+        template<class R>
+        SplitComplexMatrix<R>& SplitComplexMatrix<R>::operator-=(const SplitComplexMatrix& other)
+        {
+            checkSameShape(other);
+            for (size_t i = 0; i < m_real.size(); ++i) {
+                m_real[i] -= other.m_real[i];
+                m_imag[i] -= other.m_imag[i];
+            }
+            return *this;
+        }
+
+        template<class R>
+        SplitComplexMatrix<R>& SplitComplexMatrix<R>::operator*=(const std::complex<R>& scalar)
+        {
+            const R sr = scalar.real();
+            const R si = scalar.imag();
+            for (size_t i = 0; i < m_real.size(); ++i) {
+                const R re = m_real[i];
+                const R im = m_imag[i];
+                m_real[i] = re * sr - im * si;
+                m_imag[i] = re * si + im * sr;
+            }
+            return *this;
+        }
+
+        /**
+        * @brief Elementwise complex product, written out on the two planes so it vectorizes
+        * (std::complex operator* carries the inf/nan recovery of C Annex G, which does not).
+        * @throws std::invalid_argument if matrices have different dimensions.
+        */
+
+        template<class R>
+        SplitComplexMatrix<R>& SplitComplexMatrix<R>::hadamard(const SplitComplexMatrix& other)
+        {
+            checkSameShape(other);
+            const R* br = other.m_real.data();
+            const R* bi = other.m_imag.data();
+            for (size_t i = 0; i < m_real.size(); ++i) {
+                const R re = m_real[i];
+                const R im = m_imag[i];
+                m_real[i] = re * br[i] - im * bi[i];
+                m_imag[i] = re * bi[i] + im * br[i];
+            }
+            return *this;
+        }
+
+        template<class R>
+        SplitComplexMatrix<R>& SplitComplexMatrix<R>::conjugate()
+        {
+            for (auto& value : m_imag) {
+                value = -value;
+            }
+            return *this;
+        }
+
+        template<class U>
+        std::ostream& operator<<(std::ostream& os, const SplitComplexMatrix<U>& m)
+        {
+            return os << m.toInterleaved();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Complex GEMM
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief C = A * B by the 3M method: three real products instead of four.
+        *      T1 = Ar * Br,   T2 = Ai * Bi,   T3 = (Ar + Ai) * (Br + Bi)
+        *      Cr = T1 - T2,   Ci = T3 - T1 - T2
+        * Each real product runs on the split planes with the cache-blocked kernel, parallel over
+        * row bands of A. This saves a quarter of the multiply-adds. The imaginary part is formed
+        * by cancellation and its error bound scales with |A| |B| rather than with |Ci|, use a
+        * plain complex product where small imaginary parts must be accurate.
+        *
+        * @throws std::invalid_argument if the inner dimensions differ.
+        * @tparam R Real type of the complex elements.
+        */
+
+        template<class R>
+        SplitComplexMatrix<R> multiply3m(const SplitComplexMatrix<R>& a, const SplitComplexMatrix<R>& b)
+        {
+            if (a.getCols() != b.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            const size_t m = a.getRows();
+            const size_t n = b.getCols();
+            const size_t k = a.getCols();
+
+            std::vector<R> sumA(m * k);
+            std::vector<R> sumB(k * n);
+            for (size_t i = 0; i < m * k; ++i) {
+                sumA[i] = a.real()[i] + a.imag()[i];
+            }
+            for (size_t i = 0; i < k * n; ++i) {
+                sumB[i] = b.real()[i] + b.imag()[i];
+            }
+
+            SplitComplexMatrix<R> c(m, n);
+            std::vector<R> t2(m * n);
+            R* cr = c.real();
+            R* ci = c.imag();
+            detail::parallelFor(0, m, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                const size_t rows = hi - lo;
+                R* t1 = cr + lo * n;
+                R* t3 = ci + lo * n;
+                R* t2Band = t2.data() + lo * n;
+                detail::gemm(rows, n, k, a.real() + lo * k, k, b.real(), n, t1, n);
+                detail::gemm(rows, n, k, a.imag() + lo * k, k, b.imag(), n, t2Band, n);
+                detail::gemm(rows, n, k, sumA.data() + lo * k, k, sumB.data(), n, t3, n);
+                for (size_t i = 0; i < rows * n; ++i) {
+                    t3[i] -= t1[i] + t2Band[i];
+                    t1[i] -= t2Band[i];
+                }
+            });
+            return c;
+        }
+
+        template<class R>
+        Matrix<std::complex<R>> multiply3m(const Matrix<std::complex<R>>& a, const Matrix<std::complex<R>>& b)
+        {
+            return multiply3m(SplitComplexMatrix<R>(a), SplitComplexMatrix<R>(b)).toInterleaved();
+        }
+
+        template<class R>
+        Matrix<std::complex<R>> multiply3m(const ConjugateTranspose<std::complex<R>>& a, const Matrix<std::complex<R>>& b)
+        {
+            return multiply3m(SplitComplexMatrix<R>(a), SplitComplexMatrix<R>(b)).toInterleaved();
+        }
+
+        template<class R>
+        Matrix<std::complex<R>> multiply3m(const Matrix<std::complex<R>>& a, const ConjugateTranspose<std::complex<R>>& b)
+        {
+            return multiply3m(SplitComplexMatrix<R>(a), SplitComplexMatrix<R>(b)).toInterleaved();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Elementwise operations on interleaved complex matrices
+        //
+        // The loops address the [re, im] pairs of a row directly, which the compiler vectorizes
+        // with shuffles, rows are split over threads.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        namespace detail
+        {
+            template<class R, class Out, class Op>
+            void complexRows(const Matrix<std::complex<R>>& m, Matrix<Out>& result, Op op)
+            {
+                const size_t cols = m.getCols();
+                detail::parallelFor(0, m.getRows(), detail::elementwiseGrainRows(cols), [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        op(interleaved(m.rowData(i)), result.rowData(i), cols, i);
+                    }
+                });
+            }
+
+        }; // end namespace detail
+
+        /**
+        * @brief Elementwise complex product of two matrices.
+        * @throws std::invalid_argument if matrices have different dimensions.
+        */
+
+        template<class R>
+        Matrix<std::complex<R>> hadamard(const Matrix<std::complex<R>>& a, const Matrix<std::complex<R>>& b)
+        {
+            if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
+                throw std::invalid_argument("Matrices must have the same dimensions.");
+            }
+            Matrix<std::complex<R>> result(a.getRows(), a.getCols(), zeroFill);
+            detail::complexRows(a, result, [&](const R* x, std::complex<R>* row, size_t cols, size_t i) {
+                const R* y = detail::interleaved(b.rowData(i));
+                R* out = detail::interleaved(row);
+                for (size_t j = 0; j < cols; ++j) {
+                    const R xr = x[2 * j];
+                    const R xi = x[2 * j + 1];
+                    const R yr = y[2 * j];
+                    const R yi = y[2 * j + 1];
+                    out[2 * j] = xr * yr - xi * yi;
+                    out[2 * j + 1] = xr * yi + xi * yr;
+                }
+            });
+            return result;
+        }
+
+        // Elementwise complex conjugate.
+        template<class R>
+        Matrix<std::complex<R>> conjugate(const Matrix<std::complex<R>>& m)
+        {
+            Matrix<std::complex<R>> result(m.getRows(), m.getCols(), zeroFill);
+            detail::complexRows(m, result, [](const R* x, std::complex<R>* row, size_t cols, size_t) {
+                R* out = detail::interleaved(row);
+                for (size_t j = 0; j < cols; ++j) {
+                    out[2 * j] = x[2 * j];
+                    out[2 * j + 1] = -x[2 * j + 1];
+                }
+            });
+            return result;
+        }
+
+        // Elementwise modulus |z|, without the overflow guard of std::abs.
+        template<class R>
+        Matrix<R> magnitude(const Matrix<std::complex<R>>& m)
+        {
+            Matrix<R> result(m.getRows(), m.getCols(), zeroFill);
+            detail::complexRows(m, result, [](const R* x, R* out, size_t cols, size_t) {
+                for (size_t j = 0; j < cols; ++j) {
+                    out[j] = std::sqrt(x[2 * j] * x[2 * j] + x[2 * j + 1] * x[2 * j + 1]);
+                }
+            });
+            return result;
+        }
+
+        template<class R>
+        Matrix<R> realPart(const Matrix<std::complex<R>>& m)
+        {
+            Matrix<R> result(m.getRows(), m.getCols(), zeroFill);
+            detail::complexRows(m, result, [](const R* x, R* out, size_t cols, size_t) {
+                for (size_t j = 0; j < cols; ++j) {
+                    out[j] = x[2 * j];
+                }
+            });
+            return result;
+        }
+
+        template<class R>
+        Matrix<R> imagPart(const Matrix<std::complex<R>>& m)
+        {
+            Matrix<R> result(m.getRows(), m.getCols(), zeroFill);
+            detail::complexRows(m, result, [](const R* x, R* out, size_t cols, size_t) {
+                for (size_t j = 0; j < cols; ++j) {
+                    out[j] = x[2 * j + 1];
+                }
+            });
+            return result;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __COMPLEX_HPP__ */
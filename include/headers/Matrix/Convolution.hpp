@@ -0,0 +1,552 @@
+#ifndef __CONVOLUTION_HPP__
+#define __CONVOLUTION_HPP__
+
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+#include "Complex.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Algorithm used for a 2D convolution or correlation.
+         * Auto picks Direct for small kernels, Im2col for medium kernels and filter banks, and FFT
+         * for large kernels at unit stride when T is floating point or complex.
+         */
+        enum class ConvolutionMethod
+        {
+            Auto,
+            Direct, // sliding window, vectorized along output columns
+            Im2col, // input patches unrolled into a matrix, one GEMM per row band
+            FFT     // pointwise product of 2D FFTs, cost independent of the kernel size
+        };
+
+        /**
+         * @brief Geometry of a 2D convolution or correlation.
+         * The input is zero padded by padRows / padCols on each side, kernel taps are dilation
+         * apart and the window moves by stride. Output size along an axis is
+         *      (input + 2 * pad - dilation * (kernel - 1) - 1) / stride + 1
+         */
+        struct ConvolutionOptions
+        {
+            size_t strideRows = 1;
+            size_t strideCols = 1;
+            size_t padRows = 0;
+            size_t padCols = 0;
+            size_t dilationRows = 1;
+            size_t dilationCols = 1;
+            ConvolutionMethod method = ConvolutionMethod::Auto;
+        };
+
+
+        namespace detail
+        {
+            constexpr size_t kDirectMaxTaps = 25; // up to 5 x 5 the direct kernel wins
+            constexpr size_t kFftMinTaps = 225;   // from 15 x 15 the FFT wins at unit stride
+            constexpr size_t kIm2colBandElements = 1 << 16; // patch matrix size per GEMM call
+
+            template<class T>
+            constexpr bool kFftCapable = std::is_floating_point_v<T> || IsComplex<T>::value;
+
+            // Runs f over [begin, end) in parallel, or serially when the caller already is.
+            template<class F>
+            void forRows(bool threaded, size_t begin, size_t end, size_t grain, F&& f)
+            {
+                if (threaded) {
+                    parallelFor(begin, end, grain, f);
+                }
+                else if (begin < end) {
+                    f(begin, end);
+                }
+            }
+
+            struct ConvolutionShape
+            {
+                size_t inRows, inCols;
+                size_t kRows, kCols;
+                size_t outRows, outCols;
+                ConvolutionOptions options;
+            };
+
+            inline size_t outputSize(size_t input, size_t pad, size_t kernel, size_t dilation, size_t stride)
+            {
+                const size_t span = dilation * (kernel - 1) + 1;
+                if (input + 2 * pad < span) {
+                    throw std::invalid_argument("Dilated kernel is larger than the padded input!");
+                }
+                return (input + 2 * pad - span) / stride + 1;
+            }
+
+            template<class T>
+            ConvolutionShape convolutionShape(const Matrix<T>& input, size_t kRows, size_t kCols, const ConvolutionOptions& options)
+            {
+                if (options.strideRows == 0 || options.strideCols == 0 || options.dilationRows == 0 || options.dilationCols == 0) {
+                    throw std::invalid_argument("Stride and dilation must be positive!");
+                }
+                if (kRows == 0 || kCols == 0) {
+                    throw std::invalid_argument("Kernel must not be empty!");
+                }
+                ConvolutionShape shape{ input.getRows(), input.getCols(), kRows, kCols, 0, 0, options };
+                shape.outRows = outputSize(shape.inRows, options.padRows, kRows, options.dilationRows, options.strideRows);
+                shape.outCols = outputSize(shape.inCols, options.padCols, kCols, options.dilationCols, options.strideCols);
+                return shape;
+            }
+
+            template<class T>
+            ConvolutionMethod chooseMethod(const ConvolutionShape& shape, size_t filters)
+            {
+                const ConvolutionOptions& o = shape.options;
+                const size_t taps = shape.kRows * shape.kCols;
+                if (o.method == ConvolutionMethod::FFT && !kFftCapable<T>) {
+                    throw std::invalid_argument("FFT convolution requires floating point or complex elements!");
+                }
+                if (o.method != ConvolutionMethod::Auto) {
+                    return o.method;
+                }
+                if (kFftCapable<T> && taps >= kFftMinTaps && o.strideRows == 1 && o.strideCols == 1) {
+                    return ConvolutionMethod::FFT;
+                }
+                return taps <= kDirectMaxTaps && filters == 1 ? ConvolutionMethod::Direct : ConvolutionMethod::Im2col;
+            }
+
+            /**
+            * @brief Valid output columns [lo, hi) for which input column oj * stride + offset lies
+            * inside [0, cols), so the inner loop needs no bounds test.
+            */
+
+            inline void validColumns(std::ptrdiff_t offset, size_t stride, size_t cols, size_t outCols, size_t& lo, size_t& hi)
+            {
+                const std::ptrdiff_t s = static_cast<std::ptrdiff_t>(stride);
+                const std::ptrdiff_t first = offset < 0 ? (-offset + s - 1) / s : 0;
+                const std::ptrdiff_t last = static_cast<std::ptrdiff_t>(cols) - 1 - offset; // oj * s <= last
+                lo = static_cast<size_t>(first);
+                hi = last < 0 ? 0 : std::min(outCols, static_cast<size_t>(last / s + 1));
+                hi = std::max(lo, hi);
+            }
+
+            /**
+            * @brief Direct correlation. For each output row and kernel tap the contribution is a
+            * scaled, strided copy of one input row, added along the output row.
+            */
+
+            template<class T>
+            void correlateDirect(const Matrix<T>& input, const Matrix<T>& kernel, const ConvolutionShape& shape, T* out, bool threaded)
+            {
+                const ConvolutionOptions& o = shape.options;
+                forRows(threaded, 0, shape.outRows, 8, [&](size_t lo, size_t hi) {
+                    for (size_t oi = lo; oi < hi; ++oi) {
+                        T* row = out + oi * shape.outCols;
+                        std::fill(row, row + shape.outCols, static_cast<T>(0));
+                        for (size_t a = 0; a < shape.kRows; ++a) {
+                            const std::ptrdiff_t r = static_cast<std::ptrdiff_t>(oi * o.strideRows + a * o.dilationRows) - static_cast<std::ptrdiff_t>(o.padRows);
+                            if (r < 0 || r >= static_cast<std::ptrdiff_t>(shape.inRows)) {
+                                continue;
+                            }
+                            const T* in = input.rowData(static_cast<size_t>(r));
+                            const T* taps = kernel.rowData(a);
+                            for (size_t b = 0; b < shape.kCols; ++b) {
+                                const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(b * o.dilationCols) - static_cast<std::ptrdiff_t>(o.padCols);
+                                size_t jLo, jHi;
+                                validColumns(offset, o.strideCols, shape.inCols, shape.outCols, jLo, jHi);
+                                if (jLo == jHi) {
+                                    continue;
+                                }
+                                const T w = taps[b];
+                                const T* source = in + (static_cast<std::ptrdiff_t>(jLo * o.strideCols) + offset);
+                                T* target = row + jLo;
+                                const size_t count = jHi - jLo;
+                                if (o.strideCols == 1) {
+                                    for (size_t j = 0; j < count; ++j) {
+                                        target[j] += w * source[j];
+                                    }
+                                }
+                                else {
+                                    for (size_t j = 0; j < count; ++j) {
+                                        target[j] += w * source[j * o.strideCols];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+
+            /**
+            * @brief im2col correlation with a bank of equally sized filters.
+            * Output rows are processed in bands, each band unrolls its input patches into a
+            * (kRows * kCols) x (band pixels) matrix and one GEMM with the (filters) x (taps)
+            * filter matrix yields the band of every output.
+            */
+
+            template<class T>
+            void correlateIm2col(const Matrix<T>& input, const std::vector<const Matrix<T>*>& kernels, const ConvolutionShape& shape, const std::vector<T*>& outs, bool threaded)
+            {
+                const ConvolutionOptions& o = shape.options;
+                const size_t taps = shape.kRows * shape.kCols;
+                const size_t filters = kernels.size();
+
+                std::vector<T> weights(filters * taps);
+                for (size_t f = 0; f < filters; ++f) {
+                    for (size_t a = 0; a < shape.kRows; ++a) {
+                        std::copy(kernels[f]->rowData(a), kernels[f]->rowData(a) + shape.kCols, weights.begin() + f * taps + a * shape.kCols);
+                    }
+                }
+                const size_t bandRows = std::max<size_t>(1, kIm2colBandElements / std::max<size_t>(1, taps * shape.outCols));
+
+                forRows(threaded, 0, shape.outRows, bandRows, [&](size_t lo, size_t hi) {
+                    std::vector<T> patches;
+                    std::vector<T> result;
+                    for (size_t r0 = lo; r0 < hi; r0 += bandRows) {
+                        const size_t r1 = std::min(r0 + bandRows, hi);
+                        const size_t width = (r1 - r0) * shape.outCols;
+                        patches.assign(taps * width, static_cast<T>(0));
+                        for (size_t a = 0; a < shape.kRows; ++a) {
+                            for (size_t b = 0; b < shape.kCols; ++b) {
+                                T* patchRow = patches.data() + (a * shape.kCols + b) * width;
+                                const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(b * o.dilationCols) - static_cast<std::ptrdiff_t>(o.padCols);
+                                size_t jLo, jHi;
+                                validColumns(offset, o.strideCols, shape.inCols, shape.outCols, jLo, jHi);
+                                for (size_t oi = r0; oi < r1; ++oi) {
+                                    const std::ptrdiff_t r = static_cast<std::ptrdiff_t>(oi * o.strideRows + a * o.dilationRows) - static_cast<std::ptrdiff_t>(o.padRows);
+                                    if (r < 0 || r >= static_cast<std::ptrdiff_t>(shape.inRows)) {
+                                        continue;
+                                    }
+                                    if (jLo == jHi) {
+                                        continue;
+                                    }
+                                    const T* source = input.rowData(static_cast<size_t>(r)) + (static_cast<std::ptrdiff_t>(jLo * o.strideCols) + offset);
+                                    T* target = patchRow + (oi - r0) * shape.outCols + jLo;
+                                    for (size_t j = 0; j < jHi - jLo; ++j) {
+                                        target[j] = source[j * o.strideCols];
+                                    }
+                                }
+                            }
+                        }
+                        result.resize(filters * width);
+                        gemm(filters, width, taps, weights.data(), taps, patches.data(), width, result.data(), width);
+                        for (size_t f = 0; f < filters; ++f) {
+                            std::copy(result.begin() + f * width, result.begin() + (f + 1) * width, outs[f] + r0 * shape.outCols);
+                        }
+                    }
+                });
+            }
+
+
+            /**
+            * @brief In-place iterative radix-2 FFT of n = 2^k contiguous points.
+            * roots[j] = exp(-2 pi i j / n) for j < n / 2, the inverse transform uses their conjugates
+            * and is not scaled.
+            */
+
+            template<class R>
+            void fft(std::complex<R>* data, size_t n, const std::vector<std::complex<R>>& roots, bool inverse)
+            {
+                for (size_t i = 1, j = 0; i < n; ++i) {
+                    size_t bit = n >> 1;
+                    for (; j & bit; bit >>= 1) {
+                        j ^= bit;
+                    }
+                    j ^= bit;
+                    if (i < j) {
+                        std::swap(data[i], data[j]);
+                    }
+                }
+                for (size_t length = 2; length <= n; length <<= 1) {
+                    const size_t half = length / 2;
+                    const size_t step = n / length;
+                    for (size_t start = 0; start < n; start += length) {
+                        for (size_t k = 0; k < half; ++k) {
+                            const std::complex<R> w = inverse ? std::conj(roots[k * step]) : roots[k * step];
+                            const std::complex<R> u = data[start + k];
+                            const std::complex<R> v = data[start + k + half] * w;
+                            data[start + k] = u + v;
+                            data[start + k + half] = u - v;
+                        }
+                    }
+                }
+            }
+
+            template<class R>
+            std::vector<std::complex<R>> fftRoots(size_t n)
+            {
+                const R pi = std::acos(static_cast<R>(-1));
+                std::vector<std::complex<R>> roots(n / 2);
+                for (size_t j = 0; j < roots.size(); ++j) {
+                    roots[j] = std::polar(static_cast<R>(1), -2 * pi * static_cast<R>(j) / static_cast<R>(n));
+                }
+                return roots;
+            }
+
+            inline size_t nextPowerOfTwo(size_t n)
+            {
+                size_t p = 1;
+                while (p < n) {
+                    p <<= 1;
+                }
+                return p;
+            }
+
+            // 2D FFT of a rows x cols row-major grid, rows then columns, each pass row-parallel.
+            template<class R>
+            void fft2d(std::vector<std::complex<R>>& grid, size_t rows, size_t cols, bool inverse, bool threaded)
+            {
+                const auto rowRoots = fftRoots<R>(cols);
+                const auto colRoots = fftRoots<R>(rows);
+                forRows(threaded, 0, rows, 16, [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        fft(grid.data() + i * cols, cols, rowRoots, inverse);
+                    }
+                });
+                forRows(threaded, 0, cols, 16, [&](size_t lo, size_t hi) {
+                    std::vector<std::complex<R>> column(rows);
+                    for (size_t j = lo; j < hi; ++j) {
+                        for (size_t i = 0; i < rows; ++i) {
+                            column[i] = grid[i * cols + j];
+                        }
+                        fft(column.data(), rows, colRoots, inverse);
+                        for (size_t i = 0; i < rows; ++i) {
+                            grid[i * cols + j] = column[i];
+                        }
+                    }
+                });
+            }
+
+            /**
+            * @brief FFT correlation. The padded input and the flipped, dilated kernel are placed in
+            * grids of P x Q = next powers of two of the padded input size. Their circular
+            * convolution c holds the correlation at c[oi * stride + spanRows - 1][...], indices that
+            * never wrap around, so no further padding is needed.
+            */
+
+            template<class T>
+            void correlateFft(const Matrix<T>& input, const Matrix<T>& kernel, const ConvolutionShape& shape, T* out, bool threaded)
+            {
+                using R = Real<T>;
+                using C = std::complex<R>;
+                const ConvolutionOptions& o = shape.options;
+                const size_t spanRows = o.dilationRows * (shape.kRows - 1) + 1;
+                const size_t spanCols = o.dilationCols * (shape.kCols - 1) + 1;
+                const size_t P = nextPowerOfTwo(shape.inRows + 2 * o.padRows);
+                const size_t Q = nextPowerOfTwo(shape.inCols + 2 * o.padCols);
+
+                std::vector<C> x(P * Q, C(0));
+                std::vector<C> k(P * Q, C(0));
+                for (size_t i = 0; i < shape.inRows; ++i) {
+                    const T* in = input.rowData(i);
+                    C* target = x.data() + (i + o.padRows) * Q + o.padCols;
+                    for (size_t j = 0; j < shape.inCols; ++j) {
+                        target[j] = C(in[j]);
+                    }
+                }
+                for (size_t a = 0; a < shape.kRows; ++a) {
+                    const T* taps = kernel.rowData(a);
+                    for (size_t b = 0; b < shape.kCols; ++b) {
+                        k[(spanRows - 1 - a * o.dilationRows) * Q + (spanCols - 1 - b * o.dilationCols)] = C(taps[b]);
+                    }
+                }
+
+                fft2d(x, P, Q, false, threaded);
+                fft2d(k, P, Q, false, threaded);
+                for (size_t i = 0; i < x.size(); ++i) {
+                    x[i] *= k[i];
+                }
+                fft2d(x, P, Q, true, threaded);
+
+                const R scale = static_cast<R>(1) / static_cast<R>(P * Q);
+                for (size_t oi = 0; oi < shape.outRows; ++oi) {
+                    const C* source = x.data() + (oi * o.strideRows + spanRows - 1) * Q + spanCols - 1;
+                    T* row = out + oi * shape.outCols;
+                    for (size_t oj = 0; oj < shape.outCols; ++oj) {
+                        const C value = source[oj * o.strideCols] * scale;
+                        if constexpr (IsComplex<T>::value) {
+                            row[oj] = value;
+                        }
+                        else {
+                            row[oj] = value.real();
+                        }
+                    }
+                }
+            }
+
+            template<class T>
+            void checkKernels(const std::vector<Matrix<T>>& kernels)
+            {
+                if (kernels.empty()) {
+                    throw std::invalid_argument("Filter bank must not be empty!");
+                }
+                for (const auto& k : kernels) {
+                    if (k.getRows() != kernels.front().getRows() || k.getCols() != kernels.front().getCols()) {
+                        throw std::invalid_argument("All filters of a bank must have the same dimensions!");
+                    }
+                }
+            }
+
+            /**
+            * @brief Correlates one input with a bank of kernels into packed output buffers.
+            */
+
+            template<class T>
+            std::vector<Matrix<T>> correlateBank(const Matrix<T>& input, const std::vector<Matrix<T>>& kernels, const ConvolutionOptions& options, bool threaded)
+            {
+                checkKernels(kernels);
+                const ConvolutionShape shape = convolutionShape(input, kernels.front().getRows(), kernels.front().getCols(), options);
+                const ConvolutionMethod method = chooseMethod<T>(shape, kernels.size());
+                const size_t pixels = shape.outRows * shape.outCols;
+
+                std::vector<std::vector<T>> buffers(kernels.size(), std::vector<T>(pixels));
+                if (method == ConvolutionMethod::Im2col) {
+                    std::vector<const Matrix<T>*> bank;
+                    std::vector<T*> outs;
+                    for (size_t f = 0; f < kernels.size(); ++f) {
+                        bank.push_back(&kernels[f]);
+                        outs.push_back(buffers[f].data());
+                    }
+                    correlateIm2col(input, bank, shape, outs, threaded);
+                }
+                else {
+                    for (size_t f = 0; f < kernels.size(); ++f) {
+                        if (method == ConvolutionMethod::FFT) {
+                            if constexpr (kFftCapable<T>) {
+                                correlateFft(input, kernels[f], shape, buffers[f].data(), threaded);
+                            }
+                        }
+                        else {
+                            correlateDirect(input, kernels[f], shape, buffers[f].data(), threaded);
+                        }
+                    }
+                }
+
+                std::vector<Matrix<T>> outputs;
+                outputs.reserve(kernels.size());
+                for (const auto& buffer : buffers) {
+                    Matrix<T> result(shape.outRows, shape.outCols, zeroFill);
+                    unpack(buffer.data(), shape.outCols, result);
+                    outputs.push_back(std::move(result));
+                }
+                return outputs;
+            }
+
+            // The kernel rotated by 180 degrees, turning correlation into convolution.
+            template<class T>
+            Matrix<T> flipped(const Matrix<T>& kernel)
+            {
+                Matrix<T> result(kernel.getRows(), kernel.getCols(), zeroFill);
+                for (size_t a = 0; a < kernel.getRows(); ++a) {
+                    const T* source = kernel.rowData(kernel.getRows() - 1 - a);
+                    std::reverse_copy(source, source + kernel.getCols(), result.rowData(a));
+                }
+                return result;
+            }
+
+            template<class T>
+            std::vector<Matrix<T>> flipped(const std::vector<Matrix<T>>& kernels)
+            {
+                std::vector<Matrix<T>> result;
+                result.reserve(kernels.size());
+                for (const auto& k : kernels) {
+                    result.push_back(flipped(k));
+                }
+                return result;
+            }
+
+            /**
+            * @brief Correlates every input of a batch. Batches at least as large as the thread count
+            * run one input per task, smaller ones run inputs in turn with row-parallel kernels.
+            */
+
+            template<class T>
+            std::vector<Matrix<T>> correlateBatch(const std::vector<Matrix<T>>& inputs, const Matrix<T>& kernel, const ConvolutionOptions& options)
+            {
+                std::vector<Matrix<T>> outputs(inputs.size());
+                const std::vector<Matrix<T>> bank{ kernel };
+                if (inputs.size() >= hardwareThreads()) {
+                    parallelFor(0, inputs.size(), 1, [&](size_t lo, size_t hi) {
+                        for (size_t i = lo; i < hi; ++i) {
+                            outputs[i] = std::move(correlateBank(inputs[i], bank, options, false).front());
+                        }
+                    });
+                }
+                else {
+                    for (size_t i = 0; i < inputs.size(); ++i) {
+                        outputs[i] = std::move(correlateBank(inputs[i], bank, options, true).front());
+                    }
+                }
+                return outputs;
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // 2D correlation and convolution
+        //
+        // correlate2d computes out(i, j) = sum_a,b in(i * s + a * d - p, j * s + b * d - p) k(a, b)
+        // with zero padding, which is what CNN layers call convolution. convolve2d uses the kernel
+        // rotated by 180 degrees, the convolution of signal processing. Complex kernels are not
+        // conjugated.
+        //
+        // Example usage:
+        // \code
+        // NumeriCore::Matrix::ConvolutionOptions options;
+        // options.padRows = options.padCols = 1;
+        // auto edges = NumeriCore::Matrix::correlate2d(image, sobel, options);   // same size as image
+        // auto maps = NumeriCore::Matrix::correlate2d(image, filterBank);        // one map per filter
+        // \endcode
+        //
+        // @throws std::invalid_argument for a zero stride or dilation, an empty kernel, a dilated
+        // kernel larger than the padded input, filters of different sizes, or FFT requested for
+        // an integral element type.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        Matrix<T> correlate2d(const Matrix<T>& input, const Matrix<T>& kernel, const ConvolutionOptions& options = {})
+        {
+            return std::move(detail::correlateBank(input, std::vector<Matrix<T>>{ kernel }, options, true).front());
+        }
+
+        template<class T>
+        Matrix<T> convolve2d(const Matrix<T>& input, const Matrix<T>& kernel, const ConvolutionOptions& options = {})
+        {
+            return correlate2d(input, detail::flipped(kernel), options);
+        }
+
+        // One output per filter, Auto shares the unrolled input patches of all filters in one GEMM.
+        template<class T>
+        std::vector<Matrix<T>> correlate2d(const Matrix<T>& input, const std::vector<Matrix<T>>& kernels, const ConvolutionOptions& options = {})
+        {
+            return detail::correlateBank(input, kernels, options, true);
+        }
+
+        template<class T>
+        std::vector<Matrix<T>> convolve2d(const Matrix<T>& input, const std::vector<Matrix<T>>& kernels, const ConvolutionOptions& options = {})
+        {
+            return detail::correlateBank(input, detail::flipped(kernels), options, true);
+        }
+
+        // One output per input, parallel across the batch.
+        template<class T>
+        std::vector<Matrix<T>> correlate2d(const std::vector<Matrix<T>>& inputs, const Matrix<T>& kernel, const ConvolutionOptions& options = {})
+        {
+            return detail::correlateBatch(inputs, kernel, options);
+        }
+
+        template<class T>
+        std::vector<Matrix<T>> convolve2d(const std::vector<Matrix<T>>& inputs, const Matrix<T>& kernel, const ConvolutionOptions& options = {})
+        {
+            return detail::correlateBatch(inputs, detail::flipped(kernel), options);
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __CONVOLUTION_HPP__ */
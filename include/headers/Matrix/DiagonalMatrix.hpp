@@ -5,6 +5,8 @@
 #include <vector>
 #include <cassert>
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
 
 #include "Matrix.hpp"
 
@@ -23,8 +25,8 @@ namespace NumeriCore
             ~DiagonalMatrix() = default;
 
         public: 
-            std::vector<T>& getDiagonal() const;
-            void set_diagonal(const std::vector<T> &diagonal);
+            std::vector<T> getDiagonal() const; // get diagonal of matrix
+            void set_diagonal(const std::vector<T> &diagonal); // set diagonal of matrix
         }; 
 
 
@@ -51,7 +53,6 @@ namespace NumeriCore
                     }
                 }
             }
-            this->saveDiagonal(); 
         }
     
         template<class T>
@@ -70,7 +71,6 @@ namespace NumeriCore
                     }
                 }  
             } 
-            this->saveDiagonal(); 
         }
 
        
@@ -78,6 +78,23 @@ namespace NumeriCore
         // Diagonalmatix class methodes 
         // //////////////////////////////////////////////////////////////////////////////////////////
 
+        template<class T>
+        std::vector<T> DiagonalMatrix<T>::getDiagonal() const
+        {
+            return Matrix<T>::getDiagonal();
+        }
+
+        template<class T>
+        void DiagonalMatrix<T>::set_diagonal(const std::vector<T>& diagonal)
+        {
+            const size_t size = std::min(this->getRows(), this->getCols());
+            if (diagonal.size() != size) {
+                throw std::invalid_argument("Diagonal must have min(rows, cols) elements!");
+            }
+            for (size_t i = 0; i < size; i++) {
+                this->setElement(i, i, diagonal[i]);
+            }
+        }
 
 
     }
@@ -0,0 +1,223 @@
+#ifndef __GEMM_HPP__
+#define __GEMM_HPP__
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // GEMM epilogues
+        //
+        // An epilogue is applied to every element of C = alpha * A * B + beta * C right after it is
+        // formed, while its tile is still in cache. Any callable taking (row, col, value) or just
+        // (value) and returning the new value can be used.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        struct NoEpilogue
+        {
+            template<class T>
+            T operator()(const T& value) const { return value; }
+        };
+
+        /**
+        * @brief Adds bias[row] to every element of a row.
+        */
+        template<class T>
+        struct RowBias
+        {
+            std::vector<T> bias;
+
+            T operator()(size_t row, size_t, const T& value) const { return value + bias[row]; }
+        };
+
+        /**
+        * @brief Adds bias[col] to every element of a column.
+        */
+        template<class T>
+        struct ColumnBias
+        {
+            std::vector<T> bias;
+
+            T operator()(size_t, size_t col, const T& value) const { return value + bias[col]; }
+        };
+
+        /**
+        * @brief Clamps every element to [lower, upper], Clamp<T>{ 0, inf } is a ReLU.
+        */
+        template<class T>
+        struct Clamp
+        {
+            T lower;
+            T upper;
+
+            T operator()(const T& value) const { return std::min(std::max(value, lower), upper); }
+        };
+
+        /**
+        * @brief Several epilogues applied left to right, built with epilogues(e1, e2, ...).
+        */
+        template<class... Stages>
+        struct EpilogueChain
+        {
+            std::tuple<Stages...> stages;
+        };
+
+        template<class... Stages>
+        EpilogueChain<std::decay_t<Stages>...> epilogues(Stages&&... stages)
+        {
+            return { std::tuple<std::decay_t<Stages>...>(std::forward<Stages>(stages)...) };
+        }
+
+
+        namespace detail
+        {
+            template<class E, class T>
+            inline T applyEpilogue(const E& epilogue, size_t row, size_t col, const T& value)
+            {
+                if constexpr (std::is_invocable_v<const E&, size_t, size_t, const T&>) {
+                    return epilogue(row, col, value);
+                }
+                else {
+                    return epilogue(value);
+                }
+            }
+
+            template<class T, class... Stages>
+            inline T applyEpilogue(const EpilogueChain<Stages...>& chain, size_t row, size_t col, const T& value)
+            {
+                return std::apply([&](const auto&... stage) {
+                    T result = value;
+                    ((result = applyEpilogue(stage, row, col, result)), ...);
+                    return result;
+                }, chain.stages);
+            }
+
+            // Shape checks for the epilogues that carry data, user callables are taken as is.
+            template<class E>
+            inline void checkEpilogue(const E&, size_t, size_t)
+            {
+            }
+
+            template<class T>
+            inline void checkEpilogue(const RowBias<T>& e, size_t rows, size_t)
+            {
+                if (e.bias.size() != rows) {
+                    throw std::invalid_argument("Row bias must have one entry per row of the result!");
+                }
+            }
+
+            template<class T>
+            inline void checkEpilogue(const ColumnBias<T>& e, size_t, size_t cols)
+            {
+                if (e.bias.size() != cols) {
+                    throw std::invalid_argument("Column bias must have one entry per column of the result!");
+                }
+            }
+
+            template<class... Stages>
+            inline void checkEpilogue(const EpilogueChain<Stages...>& chain, size_t rows, size_t cols)
+            {
+                std::apply([&](const auto&... stage) { (checkEpilogue(stage, rows, cols), ...); }, chain.stages);
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Fused general matrix product C = epilogue(alpha * A * B + beta * C) in place.
+        * B is packed once, then each parallel row band of A is packed and multiplied one
+        * gemmBlockRows x gemmBlockCols tile at a time (see TuningParameters). The scaling, the beta * C term and the
+        * epilogue are applied while writing each tile back, so C is read and written in a single
+        * pass and no temporaries of its size are created. As in BLAS, C is not read when beta is
+        * zero. C may be the same matrix as A or B.
+        *
+        * Example usage:
+        * \code
+        * // out = max(0, W * x + b)
+        * NumeriCore::Matrix::gemm(1.0, w, x, 0.0, out,
+        *     NumeriCore::Matrix::epilogues(NumeriCore::Matrix::RowBias<double>{ b },
+        *                                   [](double v) { return std::max(v, 0.0); }));
+        * \endcode
+        *
+        * @param alpha Scale of the product.
+        * @param a Left factor, m x k.
+        * @param b Right factor, k x n.
+        * @param beta Scale of the previous contents of c.
+        * @param c Destination, m x n.
+        * @param epilogue Applied to every element of the result.
+        * @throw std::invalid_argument If the shapes do not match.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T, class Epilogue = NoEpilogue>
+        void gemm(const T& alpha, const Matrix<T>& a, const Matrix<T>& b, const T& beta, Matrix<T>& c, const Epilogue& epilogue = Epilogue{})
+        {
+            if (a.getCols() != b.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            if (c.getRows() != a.getRows() || c.getCols() != b.getCols()) {
+                throw std::invalid_argument("Destination matrix must have the rows of the first and the columns of the second matrix!");
+            }
+            const size_t m = a.getRows();
+            const size_t n = b.getCols();
+            const size_t k = a.getCols();
+            detail::checkEpilogue(epilogue, m, n);
+            if (m == 0 || n == 0) {
+                return;
+            }
+
+            const std::vector<T> packedB = detail::pack(b);
+            const bool readC = beta != static_cast<T>(0);
+            std::vector<T*> rowsOfC(m); // taken serially, the non-const rowData() marks c modified
+            for (size_t i = 0; i < m; ++i) {
+                rowsOfC[i] = c.rowData(i);
+            }
+
+            const TuningParameters tuning = detail::currentTuning();
+
+            detail::parallelFor(0, m, tuning.gemmGrainRows, [&](size_t lo, size_t hi) {
+                std::vector<T> band((hi - lo) * k);
+                for (size_t i = lo; i < hi; ++i) {
+                    std::copy(a.rowData(i), a.rowData(i) + k, band.begin() + (i - lo) * k);
+                }
+                std::vector<T> tile(tuning.gemmBlockRows * std::min(n, tuning.gemmBlockCols));
+
+                for (size_t i0 = lo; i0 < hi; i0 += tuning.gemmBlockRows) {
+                    const size_t rows = std::min(tuning.gemmBlockRows, hi - i0);
+                    for (size_t j0 = 0; j0 < n; j0 += tuning.gemmBlockCols) {
+                        const size_t cols = std::min(tuning.gemmBlockCols, n - j0);
+                        detail::gemm(rows, cols, k, band.data() + (i0 - lo) * k, k, packedB.data() + j0, n, tile.data(), cols);
+
+                        for (size_t r = 0; r < rows; ++r) {
+                            const T* acc = tile.data() + r * cols;
+                            T* out = rowsOfC[i0 + r] + j0;
+                            if (readC) {
+                                for (size_t j = 0; j < cols; ++j) {
+                                    out[j] = detail::applyEpilogue(epilogue, i0 + r, j0 + j, alpha * acc[j] + beta * out[j]);
+                                }
+                            }
+                            else {
+                                for (size_t j = 0; j < cols; ++j) {
+                                    out[j] = detail::applyEpilogue(epilogue, i0 + r, j0 + j, alpha * acc[j]);
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __GEMM_HPP__ */
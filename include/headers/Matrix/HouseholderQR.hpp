@@ -0,0 +1,347 @@
+#ifndef __HOUSEHOLDERQR_HPP__
+#define __HOUSEHOLDERQR_HPP__
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "TriangularMatrix.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Householder QR factorization A = Q * R of an m x n matrix with m >= n.
+         * Q is kept as a sequence of block reflectors in compact WY form, H = I - V * T * V^T, so
+         * applying Q or Q^T to a block of right-hand sides is two GEMMs and one TRMM per block.
+         * Least-squares solves reuse the factorization without touching A again.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::HouseholderQR<double> qr(design);
+         * auto coefficients = qr.solve(observations); // min || design * x - observations ||
+         * \endcode
+         */
+        template<class T>
+        class HouseholderQR
+        {
+        public:
+            explicit HouseholderQR(const Matrix<T>& a, size_t blockSize = 32);
+
+            ~HouseholderQR() = default;
+
+        public:
+            Matrix<T> solve(const Matrix<T>& b) const; // least-squares solution of A * x = b
+            Matrix<T> applyQt(const Matrix<T>& b) const; // Q^T * b
+            Matrix<T> applyQ(const Matrix<T>& b) const; // Q * b
+            TriangularMatrix<T> getR() const; // n x n upper triangular factor
+            Matrix<T> getQ() const; // thin m x n orthonormal factor
+
+            size_t getRows() const; // rows of A
+            size_t getCols() const; // cols of A
+
+        private:
+            struct BlockReflector
+            {
+                size_t offset;      // first row the reflector acts on
+                size_t size;        // number of reflectors in the block
+                std::vector<T> v;   // (m - offset) x size, unit lower trapezoidal
+                std::vector<T> vt;  // V^T
+                std::vector<T> t;   // size x size upper triangular
+                std::vector<T> tt;  // T^T
+            };
+
+            void applyBlock(const BlockReflector& block, bool transpose, T* b, size_t ldb, size_t cols) const;
+            void applyAll(std::vector<T>& b, size_t cols, bool transpose) const;
+
+        private:
+            size_t m_rows = 0;
+            size_t m_cols = 0;
+            std::vector<T> m_r; // R packed row by row
+            std::vector<BlockReflector> m_blocks;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // HouseholderQR class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Factorizes a with blocked Householder reflections.
+         * Each panel of blockSize columns is reduced column by column, its reflectors are
+         * accumulated into V and T, and the trailing columns are updated with the block reflector.
+         *
+         * @param a The matrix to factorize.
+         * @param blockSize Number of columns per panel.
+         * @throw std::invalid_argument If a has fewer rows than columns.
+         * @tparam T Type of matrix elements.
+         */
+
+        template<class T>
+        HouseholderQR<T>::HouseholderQR(const Matrix<T>& a, size_t blockSize)
+            : m_rows(a.getRows())
+            , m_cols(a.getCols())
+        {
+            if (m_rows < m_cols) {
+                throw std::invalid_argument("QR factorization requires at least as many rows as columns!");
+            }
+
+            const size_t m = m_rows;
+            const size_t n = m_cols;
+            const size_t nb = std::max<size_t>(blockSize, 1);
+            std::vector<T> buffer = detail::pack(a);
+            T* A = buffer.data();
+            std::vector<T> w;
+
+            for (size_t k = 0; k < n; k += nb) {
+                const size_t kb = std::min(nb, n - k);
+                const size_t mk = m - k;
+                std::vector<T> taus(kb, static_cast<T>(0));
+
+                for (size_t jj = 0; jj < kb; ++jj) {
+                    const size_t j = k + jj;
+                    const T alpha = A[j * n + j];
+                    T sigma = static_cast<T>(0);
+                    for (size_t i = j + 1; i < m; ++i) {
+                        sigma += A[i * n + j] * A[i * n + j];
+                    }
+                    if (sigma == static_cast<T>(0)) {
+                        continue;
+                    }
+
+                    const T norm = std::sqrt(alpha * alpha + sigma);
+                    const T beta = alpha <= static_cast<T>(0) ? norm : -norm;
+                    const T tau = (beta - alpha) / beta;
+                    const T scale = static_cast<T>(1) / (alpha - beta);
+                    for (size_t i = j + 1; i < m; ++i) {
+                        A[i * n + j] *= scale;
+                    }
+                    A[j * n + j] = beta;
+                    taus[jj] = tau;
+
+                    // apply H_j to the remaining panel columns, row by row
+                    const size_t panelEnd = k + kb;
+                    w.assign(A + j * n + j + 1, A + j * n + panelEnd);
+                    for (size_t i = j + 1; i < m; ++i) {
+                        const T v = A[i * n + j];
+                        for (size_t c = j + 1; c < panelEnd; ++c) {
+                            w[c - j - 1] += v * A[i * n + c];
+                        }
+                    }
+                    for (size_t c = j + 1; c < panelEnd; ++c) {
+                        A[j * n + c] -= tau * w[c - j - 1];
+                    }
+                    for (size_t i = j + 1; i < m; ++i) {
+                        const T v = tau * A[i * n + j];
+                        for (size_t c = j + 1; c < panelEnd; ++c) {
+                            A[i * n + c] -= v * w[c - j - 1];
+                        }
+                    }
+                }
+
+                BlockReflector block;
+                block.offset = k;
+                block.size = kb;
+                block.v.assign(mk * kb, static_cast<T>(0));
+                block.vt.assign(kb * mk, static_cast<T>(0));
+                block.t.assign(kb * kb, static_cast<T>(0));
+                block.tt.assign(kb * kb, static_cast<T>(0));
+
+                for (size_t i = 0; i < mk; ++i) {
+                    for (size_t jj = 0; jj < kb && jj <= i; ++jj) {
+                        const T v = i == jj ? static_cast<T>(1) : A[(k + i) * n + k + jj];
+                        block.v[i * kb + jj] = v;
+                        block.vt[jj * mk + i] = v;
+                    }
+                }
+
+                // T(0:j, j) = -tau_j * T(0:j, 0:j) * V(:, 0:j)^T * v_j
+                std::vector<T> z(kb);
+                for (size_t jj = 0; jj < kb; ++jj) {
+                    const T* vj = block.vt.data() + jj * mk;
+                    for (size_t p = 0; p < jj; ++p) {
+                        const T* vp = block.vt.data() + p * mk;
+                        T sum = static_cast<T>(0);
+                        for (size_t i = jj; i < mk; ++i) {
+                            sum += vp[i] * vj[i];
+                        }
+                        z[p] = sum;
+                    }
+                    for (size_t p = 0; p < jj; ++p) {
+                        T sum = static_cast<T>(0);
+                        for (size_t q = p; q < jj; ++q) {
+                            sum += block.t[p * kb + q] * z[q];
+                        }
+                        block.t[p * kb + jj] = -taus[jj] * sum;
+                    }
+                    block.t[jj * kb + jj] = taus[jj];
+                }
+                for (size_t p = 0; p < kb; ++p) {
+                    for (size_t q = 0; q < kb; ++q) {
+                        block.tt[q * kb + p] = block.t[p * kb + q];
+                    }
+                }
+
+                if (k + kb < n) {
+                    applyBlock(block, true, A + k * n + k + kb, n, n - k - kb);
+                }
+                m_blocks.push_back(std::move(block));
+            }
+
+            m_r.resize(detail::packedSize(n));
+            for (size_t i = 0; i < n; ++i) {
+                std::copy(A + i * n + i, A + i * n + n, m_r.begin() + i * (2 * n - i + 1) / 2);
+            }
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // HouseholderQR class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Applies one block reflector, B = (I - V op(T) V^T) * B.
+         * op(T) is T^T when transpose is set (for Q^T) and T otherwise. Column blocks of B are
+         * independent and run in parallel.
+         */
+
+        template<class T>
+        void HouseholderQR<T>::applyBlock(const BlockReflector& block, bool transpose, T* b, size_t ldb, size_t cols) const
+        {
+            const size_t mk = m_rows - block.offset;
+            const size_t kb = block.size;
+
+            detail::parallelFor(0, cols, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                const size_t width = hi - lo;
+                std::vector<T> w(kb * width);
+                std::vector<T> tw(kb * width);
+
+                detail::gemm(kb, width, mk, block.vt.data(), mk, b + lo, ldb, w.data(), width);
+                if (transpose) {
+                    detail::trmmLeft(true, false, kb, width, detail::DenseRows<const T>{ block.tt.data(), kb }, w.data(), width, tw.data(), width);
+                } else {
+                    detail::trmmLeft(false, false, kb, width, detail::DenseRows<const T>{ block.t.data(), kb }, w.data(), width, tw.data(), width);
+                }
+                for (auto& element : tw) {
+                    element = -element;
+                }
+                detail::gemm(mk, width, kb, block.v.data(), kb, tw.data(), width, b + lo, ldb, true);
+            });
+        }
+
+        template<class T>
+        void HouseholderQR<T>::applyAll(std::vector<T>& b, size_t cols, bool transpose) const
+        {
+            if (transpose) {
+                for (const auto& block : m_blocks) {
+                    applyBlock(block, true, b.data() + block.offset * cols, cols, cols);
+                }
+            } else {
+                for (auto it = m_blocks.rbegin(); it != m_blocks.rend(); ++it) {
+                    applyBlock(*it, false, b.data() + it->offset * cols, cols, cols);
+                }
+            }
+        }
+
+        template<class T>
+        inline Matrix<T> HouseholderQR<T>::applyQt(const Matrix<T>& b) const
+        {
+            if (b.getRows() != m_rows) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the factorized matrix.");
+            }
+            std::vector<T> buffer = detail::pack(b);
+            applyAll(buffer, b.getCols(), true);
+            Matrix<T> result(b.getRows(), b.getCols(), zeroFill);
+            detail::unpack(buffer.data(), b.getCols(), result);
+            return result;
+        }
+
+        template<class T>
+        inline Matrix<T> HouseholderQR<T>::applyQ(const Matrix<T>& b) const
+        {
+            if (b.getRows() != m_rows) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the factorized matrix.");
+            }
+            std::vector<T> buffer = detail::pack(b);
+            applyAll(buffer, b.getCols(), false);
+            Matrix<T> result(b.getRows(), b.getCols(), zeroFill);
+            detail::unpack(buffer.data(), b.getCols(), result);
+            return result;
+        }
+
+
+        /**
+        * @brief Least-squares solve, minimizes || A * x - b || for every column of b.
+        * Computes Q^T * b with the stored reflectors and back-substitutes with R.
+        * @param b Right-hand sides, one per column.
+        * @throws std::invalid_argument if b has the wrong number of rows.
+        * @throws std::runtime_error if R is singular, i.e. A is rank deficient.
+        * @return The n x b.getCols() solution.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline Matrix<T> HouseholderQR<T>::solve(const Matrix<T>& b) const
+        {
+            if (b.getRows() != m_rows) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the factorized matrix.");
+            }
+            const size_t r = b.getCols();
+            std::vector<T> buffer = detail::pack(b);
+            applyAll(buffer, r, true);
+
+            const detail::PackedUpperRows<const T> rows{ m_r.data(), m_cols };
+            detail::parallelFor(0, r, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::trsmLeft(false, false, m_cols, hi - lo, rows, buffer.data() + lo, r);
+            });
+
+            Matrix<T> result(m_cols, r, zeroFill);
+            detail::unpack(buffer.data(), r, result);
+            return result;
+        }
+
+        template<class T>
+        inline TriangularMatrix<T> HouseholderQR<T>::getR() const
+        {
+            TriangularMatrix<T> result(m_cols, Triangle::Upper, false, "QRFactorR");
+            for (size_t i = 0; i < m_cols; ++i) {
+                for (size_t j = i; j < m_cols; ++j) {
+                    result.setElement(i, j, m_r[i * (2 * m_cols - i + 1) / 2 + (j - i)]);
+                }
+            }
+            return result;
+        }
+
+        template<class T>
+        inline Matrix<T> HouseholderQR<T>::getQ() const
+        {
+            std::vector<T> buffer(m_rows * m_cols, static_cast<T>(0));
+            for (size_t i = 0; i < m_cols; ++i) {
+                buffer[i * m_cols + i] = static_cast<T>(1);
+            }
+            applyAll(buffer, m_cols, false);
+            Matrix<T> result(m_rows, m_cols, zeroFill);
+            detail::unpack(buffer.data(), m_cols, result);
+            return result;
+        }
+
+        template<class T>
+        inline size_t HouseholderQR<T>::getRows() const
+        {
+            return m_rows;
+        }
+
+        template<class T>
+        inline size_t HouseholderQR<T>::getCols() const
+        {
+            return m_cols;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __HOUSEHOLDERQR_HPP__ */
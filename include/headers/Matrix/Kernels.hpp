@@ -0,0 +1,460 @@
+#ifndef __KERNELS_HPP__
+#define __KERNELS_HPP__
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Parallel.hpp"
+#include "Tuning.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        namespace detail
+        {
+            // ////////////////////////////////////////////////////////////////////////////////////////
+            // Dense row-major buffers shared by the structured kernels
+            // ////////////////////////////////////////////////////////////////////////////////////////
+
+            /**
+            * @brief Copies a matrix into a contiguous row-major buffer.
+            * @param m The matrix to pack.
+            * @param ld Leading dimension of the buffer (must be >= m.getCols()).
+            * @param rows Number of rows in the buffer (must be >= m.getRows()), the padding is zeroed.
+            * @return The packed buffer of size rows * ld.
+            * @tparam T Type of matrix elements.
+            */
+
+            template<class T>
+            inline std::vector<T> pack(const Matrix<T>& m, size_t ld, size_t rows)
+            {
+                std::vector<T> buffer(rows * ld, static_cast<T>(0));
+                for (size_t i = 0; i < m.getRows(); ++i) {
+                    std::copy(m.rowData(i), m.rowData(i) + m.getCols(), buffer.begin() + i * ld);
+                }
+                return buffer;
+            }
+
+            template<class T>
+            inline std::vector<T> pack(const Matrix<T>& m)
+            {
+                return pack(m, m.getCols(), m.getRows());
+            }
+
+
+            /**
+            * @brief Copies the leading rows x cols block of a row-major buffer back into a matrix.
+            * @param buffer Source buffer.
+            * @param ld Leading dimension of the buffer.
+            * @param m Destination matrix, its dimensions select the block that is copied.
+            * @tparam T Type of matrix elements.
+            */
+
+            template<class T>
+            inline void unpack(const T* buffer, size_t ld, Matrix<T>& m)
+            {
+                for (size_t i = 0; i < m.getRows(); ++i) {
+                    std::copy(buffer + i * ld, buffer + i * ld + m.getCols(), m.rowData(i));
+                }
+            }
+
+
+            /**
+            * @brief Cache-blocked general matrix product C (+)= A * B on row-major views.
+            * The innermost loop runs over contiguous rows of B and C so the compiler can vectorize it.
+            *
+            * @param m Rows of A and C.
+            * @param n Columns of B and C.
+            * @param k Columns of A and rows of B.
+            * @param A Pointer to A with leading dimension lda.
+            * @param B Pointer to B with leading dimension ldb.
+            * @param C Pointer to C with leading dimension ldc.
+            * @param accumulate If false C is overwritten, otherwise the product is added to C.
+            * @tparam T Type of matrix elements.
+            */
+
+            template<class T>
+            inline void gemm(size_t m, size_t n, size_t k,
+                             const T* A, size_t lda,
+                             const T* B, size_t ldb,
+                             T* C, size_t ldc,
+                             bool accumulate = false)
+            {
+                if (!accumulate) {
+                    for (size_t i = 0; i < m; ++i) {
+                        std::fill(C + i * ldc, C + i * ldc + n, static_cast<T>(0));
+                    }
+                }
+
+                const TuningParameters tuning = currentTuning();
+                for (size_t jj = 0; jj < n; jj += tuning.gemmBlockCols) {
+                    const size_t jEnd = std::min(jj + tuning.gemmBlockCols, n);
+                    for (size_t kk = 0; kk < k; kk += tuning.gemmBlockInner) {
+                        const size_t kEnd = std::min(kk + tuning.gemmBlockInner, k);
+                        for (size_t ii = 0; ii < m; ii += tuning.gemmBlockRows) {
+                            const size_t iEnd = std::min(ii + tuning.gemmBlockRows, m);
+                            for (size_t i = ii; i < iEnd; ++i) {
+                                T* cRow = C + i * ldc;
+                                for (size_t p = kk; p < kEnd; ++p) {
+                                    const T a = A[i * lda + p];
+                                    const T* bRow = B + p * ldb;
+                                    for (size_t j = jj; j < jEnd; ++j) {
+                                        cRow[j] += a * bRow[j];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+
+            // ////////////////////////////////////////////////////////////////////////////////////////
+            // Row accessors for triangular operands
+            // Element (i, j) of the stored triangle is rows(i)[j] for dense and packed storage alike,
+            // so the kernels below are written once for both.
+            // ////////////////////////////////////////////////////////////////////////////////////////
+
+            template<class T>
+            struct DenseRows
+            {
+                T* data;
+                size_t ld;
+                T* operator()(size_t i) const { return data + i * ld; }
+            };
+
+            template<class T>
+            struct PackedLowerRows // row i holds columns 0..i
+            {
+                T* data;
+                T* operator()(size_t i) const { return data + i * (i + 1) / 2; }
+            };
+
+            template<class T>
+            struct PackedUpperRows // row i holds columns i..n-1
+            {
+                T* data;
+                size_t n;
+                T* operator()(size_t i) const { return data + i * (2 * n - i + 1) / 2 - i; }
+            };
+
+            inline size_t packedSize(size_t n)
+            {
+                return n * (n + 1) / 2;
+            }
+
+
+            /**
+            * @brief Symmetric rank-k update of the lower triangle, C = A^T * A.
+            * A is k x n, only the n (n + 1) / 2 elements of the lower triangle of C are computed.
+            */
+
+            template<class T, class Rows>
+            inline void syrkTransposed(size_t n, size_t k, const T* A, size_t lda, Rows C)
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    std::fill(C(i), C(i) + i + 1, static_cast<T>(0));
+                }
+
+                const TuningParameters tuning = currentTuning();
+                for (size_t ii = 0; ii < n; ii += tuning.gemmBlockRows) {
+                    const size_t iEnd = std::min(ii + tuning.gemmBlockRows, n);
+                    for (size_t pp = 0; pp < k; pp += tuning.gemmBlockInner) {
+                        const size_t pEnd = std::min(pp + tuning.gemmBlockInner, k);
+                        for (size_t p = pp; p < pEnd; ++p) {
+                            const T* aRow = A + p * lda;
+                            for (size_t i = ii; i < iEnd; ++i) {
+                                const T a = aRow[i];
+                                T* cRow = C(i);
+                                for (size_t j = 0; j <= i; ++j) {
+                                    cRow[j] += a * aRow[j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Symmetric rank-k update of the lower triangle, C = A * A^T.
+            * A is n x k, every element of C is a dot product of two contiguous rows of A.
+            */
+
+            template<class T, class Rows>
+            inline void syrk(size_t n, size_t k, const T* A, size_t lda, Rows C)
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    const T* aRow = A + i * lda;
+                    T* cRow = C(i);
+                    for (size_t j = 0; j <= i; ++j) {
+                        const T* bRow = A + j * lda;
+                        T sum = static_cast<T>(0);
+                        for (size_t p = 0; p < k; ++p) {
+                            sum += aRow[p] * bRow[p];
+                        }
+                        cRow[j] = sum;
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Symmetric times general product C = S * B with S stored as its lower triangle.
+            * Every stored element of S is read once and applied to both mirrored positions.
+            * S is n x n, B and C are n x m.
+            */
+
+            template<class T, class Rows>
+            inline void symmLeft(size_t n, size_t m, Rows S, const T* B, size_t ldb, T* C, size_t ldc)
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    std::fill(C + i * ldc, C + i * ldc + m, static_cast<T>(0));
+                }
+
+                for (size_t i = 0; i < n; ++i) {
+                    const auto* sRow = S(i);
+                    const T* bi = B + i * ldb;
+                    T* ci = C + i * ldc;
+                    for (size_t p = 0; p < i; ++p) {
+                        const T s = sRow[p];
+                        const T* bp = B + p * ldb;
+                        T* cp = C + p * ldc;
+                        for (size_t j = 0; j < m; ++j) {
+                            ci[j] += s * bp[j];
+                            cp[j] += s * bi[j];
+                        }
+                    }
+                    const T d = sRow[i];
+                    for (size_t j = 0; j < m; ++j) {
+                        ci[j] += d * bi[j];
+                    }
+                }
+            }
+
+
+            /**
+            * @brief General times symmetric product C = B * S with S stored as its lower triangle.
+            * B and C are m x n, S is n x n.
+            */
+
+            template<class T, class Rows>
+            inline void symmRight(size_t m, size_t n, const T* B, size_t ldb, Rows S, T* C, size_t ldc)
+            {
+                for (size_t i = 0; i < m; ++i) {
+                    const T* bi = B + i * ldb;
+                    T* ci = C + i * ldc;
+                    std::fill(ci, ci + n, static_cast<T>(0));
+                    for (size_t p = 0; p < n; ++p) {
+                        const auto* sRow = S(p);
+                        const T b = bi[p];
+                        T mirrored = static_cast<T>(0);
+                        for (size_t j = 0; j < p; ++j) {
+                            ci[j] += b * sRow[j];
+                            mirrored += bi[j] * sRow[j];
+                        }
+                        ci[p] += mirrored + b * sRow[p];
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Triangular times general product C = op(T) * B.
+            * T is n x n, B and C are n x m. Only the stored triangle of T is read, a unit diagonal is
+            * implied if unit is set.
+            */
+
+            template<class T, class Rows>
+            inline void trmmLeft(bool lower, bool unit, size_t n, size_t m, Rows tri, const T* B, size_t ldb, T* C, size_t ldc)
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    const auto* tRow = tri(i);
+                    T* ci = C + i * ldc;
+                    const size_t pBegin = lower ? 0 : i + 1;
+                    const size_t pEnd = lower ? i : n;
+                    const T d = unit ? static_cast<T>(1) : tRow[i];
+                    const T* bi = B + i * ldb;
+                    for (size_t j = 0; j < m; ++j) {
+                        ci[j] = d * bi[j];
+                    }
+                    for (size_t p = pBegin; p < pEnd; ++p) {
+                        const T t = tRow[p];
+                        const T* bp = B + p * ldb;
+                        for (size_t j = 0; j < m; ++j) {
+                            ci[j] += t * bp[j];
+                        }
+                    }
+                }
+            }
+
+
+            /**
+            * @brief General times triangular product C = B * T.
+            * B and C are m x n, T is n x n.
+            */
+
+            template<class T, class Rows>
+            inline void trmmRight(bool lower, bool unit, size_t m, size_t n, const T* B, size_t ldb, Rows tri, T* C, size_t ldc)
+            {
+                for (size_t i = 0; i < m; ++i) {
+                    const T* bi = B + i * ldb;
+                    T* ci = C + i * ldc;
+                    std::fill(ci, ci + n, static_cast<T>(0));
+                    for (size_t p = 0; p < n; ++p) {
+                        const auto* tRow = tri(p);
+                        const T b = bi[p];
+                        const size_t jBegin = lower ? 0 : p + 1;
+                        const size_t jEnd = lower ? p : n;
+                        for (size_t j = jBegin; j < jEnd; ++j) {
+                            ci[j] += b * tRow[j];
+                        }
+                        ci[p] += b * (unit ? static_cast<T>(1) : tRow[p]);
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Triangular solve T * X = B, X overwrites B.
+            * Forward substitution for lower, backward substitution for upper triangles, applied to
+            * whole rows of B so the inner loop is contiguous. T is n x n, B is n x m.
+            * @throws std::runtime_error if a diagonal element is zero.
+            */
+
+            template<class T, class Rows>
+            inline void trsmLeft(bool lower, bool unit, size_t n, size_t m, Rows tri, T* B, size_t ldb)
+            {
+                for (size_t step = 0; step < n; ++step) {
+                    const size_t i = lower ? step : n - 1 - step;
+                    const auto* tRow = tri(i);
+                    T* bi = B + i * ldb;
+                    const size_t pBegin = lower ? 0 : i + 1;
+                    const size_t pEnd = lower ? i : n;
+                    for (size_t p = pBegin; p < pEnd; ++p) {
+                        const T t = tRow[p];
+                        const T* bp = B + p * ldb;
+                        for (size_t j = 0; j < m; ++j) {
+                            bi[j] -= t * bp[j];
+                        }
+                    }
+                    if (!unit) {
+                        const T d = tRow[i];
+                        if (d == static_cast<T>(0)) {
+                            throw std::runtime_error("Triangular matrix is singular.");
+                        }
+                        for (size_t j = 0; j < m; ++j) {
+                            bi[j] /= d;
+                        }
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Triangular solve X * T = B, X overwrites B.
+            * B is m x n, T is n x n.
+            * @throws std::runtime_error if a diagonal element is zero.
+            */
+
+            template<class T, class Rows>
+            inline void trsmRight(bool lower, bool unit, size_t m, size_t n, Rows tri, T* B, size_t ldb)
+            {
+                for (size_t i = 0; i < m; ++i) {
+                    T* bi = B + i * ldb;
+                    for (size_t step = 0; step < n; ++step) {
+                        const size_t p = lower ? n - 1 - step : step;
+                        const auto* tRow = tri(p);
+                        if (!unit) {
+                            if (tRow[p] == static_cast<T>(0)) {
+                                throw std::runtime_error("Triangular matrix is singular.");
+                            }
+                            bi[p] /= tRow[p];
+                        }
+                        const T x = bi[p];
+                        const size_t jBegin = lower ? 0 : p + 1;
+                        const size_t jEnd = lower ? p : n;
+                        for (size_t j = jBegin; j < jEnd; ++j) {
+                            bi[j] -= x * tRow[j];
+                        }
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Triangular solve op(T)^T * X = B, X overwrites B.
+            * Uses the rows of T as columns of T^T, so no transposed copy is needed. T is n x n, B is n x m.
+            * @throws std::runtime_error if a diagonal element is zero.
+            */
+
+            template<class T, class Rows>
+            inline void trsmLeftTransposed(bool lower, bool unit, size_t n, size_t m, Rows tri, T* B, size_t ldb)
+            {
+                for (size_t step = 0; step < n; ++step) {
+                    const size_t i = lower ? n - 1 - step : step;
+                    const auto* tRow = tri(i);
+                    T* bi = B + i * ldb;
+                    if (!unit) {
+                        const T d = tRow[i];
+                        if (d == static_cast<T>(0)) {
+                            throw std::runtime_error("Triangular matrix is singular.");
+                        }
+                        for (size_t j = 0; j < m; ++j) {
+                            bi[j] /= d;
+                        }
+                    }
+                    const size_t pBegin = lower ? 0 : i + 1;
+                    const size_t pEnd = lower ? i : n;
+                    for (size_t p = pBegin; p < pEnd; ++p) {
+                        const T t = tRow[p];
+                        T* bp = B + p * ldb;
+                        for (size_t j = 0; j < m; ++j) {
+                            bp[j] -= t * bi[j];
+                        }
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Triangular solve X * op(T)^T = B, X overwrites B.
+            * Every element of X is a dot product of a row of T with the already solved part of the
+            * same row of X. B is m x n, T is n x n.
+            * @throws std::runtime_error if a diagonal element is zero.
+            */
+
+            template<class T, class Rows>
+            inline void trsmRightTransposed(bool lower, bool unit, size_t m, size_t n, Rows tri, T* B, size_t ldb)
+            {
+                for (size_t i = 0; i < m; ++i) {
+                    T* bi = B + i * ldb;
+                    for (size_t step = 0; step < n; ++step) {
+                        const size_t j = lower ? step : n - 1 - step;
+                        const auto* tRow = tri(j);
+                        const size_t pBegin = lower ? 0 : j + 1;
+                        const size_t pEnd = lower ? j : n;
+                        T sum = bi[j];
+                        for (size_t p = pBegin; p < pEnd; ++p) {
+                            sum -= tRow[p] * bi[p];
+                        }
+                        if (!unit) {
+                            if (tRow[j] == static_cast<T>(0)) {
+                                throw std::runtime_error("Triangular matrix is singular.");
+                            }
+                            sum /= tRow[j];
+                        }
+                        bi[j] = sum;
+                    }
+                }
+            }
+
+        }; // end namespace detail
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __KERNELS_HPP__ */
@@ -0,0 +1,679 @@
+#ifndef __KRYLOV_HPP__
+#define __KRYLOV_HPP__
+
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+#include "DiagonalMatrix.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Stopping criteria and monitoring for the Krylov solvers.
+         *
+         * tolerance      : stop once ||b - A x|| <= tolerance * ||b||.
+         * maxIterations  : upper bound for solver iterations, not for products with A. Each solver
+         *                  applies A once for the initial residual (GMRES once per restart) and then
+         *                  once per CG or GMRES iteration, twice per BiCGSTAB iteration.
+         * restart        : Krylov subspace dimension of restarted GMRES.
+         * recordHistory  : keep the relative residual of every iteration in KrylovResult::history.
+         * monitor        : called after every iteration with (iteration, relative residual), returning
+         *                  false terminates the solve early.
+         */
+        struct KrylovConfig
+        {
+            double tolerance = 1e-8;
+            size_t maxIterations = 1000;
+            size_t restart = 30;
+            bool recordHistory = false;
+            std::function<bool(size_t, double)> monitor;
+        };
+
+
+        struct KrylovResult
+        {
+            size_t iterations = 0;
+            double residual = 0.0;      // final relative residual
+            bool converged = false;
+            bool stopped = false;       // the monitor requested termination
+            bool breakdown = false;     // the recurrence broke down before convergence
+            std::vector<double> history;
+        };
+
+
+        /**
+         * @brief Pool of vectors reused by the Krylov solvers.
+         * Every solver takes its temporaries from numbered slots at the start of a solve and never
+         * allocates inside the iteration. Passing the same workspace to repeated solves of the same
+         * size makes them allocation free.
+         */
+        template<class T>
+        class KrylovWorkspace
+        {
+        public:
+            std::vector<T>& get(size_t slot, size_t size); // vector of the given size in slot
+
+        private:
+            std::deque<std::vector<T>> m_vectors; // deque keeps references stable while growing
+        };
+
+        template<class T>
+        inline std::vector<T>& KrylovWorkspace<T>::get(size_t slot, size_t size)
+        {
+            while (m_vectors.size() <= slot) {
+                m_vectors.emplace_back();
+            }
+            m_vectors[slot].resize(size);
+            return m_vectors[slot];
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Operators and preconditioners
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Matrix-vector product of a dense matrix, y = A * x.
+         * Packs A once so repeated products read contiguous rows. Rows are split over a set of
+         * workers started with the operator and kept for its lifetime, so a product in the
+         * iteration loop spawns no threads and allocates nothing. Copies share the workers,
+         * concurrent products on one operator run one after the other.
+         * Any callable with the signature void(const std::vector<T>& x, std::vector<T>& y) can be
+         * used in its place, e.g. a sparse product or a matrix-free callback.
+         */
+        template<class T>
+        class DenseOperator
+        {
+        public:
+            explicit DenseOperator(const Matrix<T>& a);
+
+            void operator()(const std::vector<T>& x, std::vector<T>& y) const;
+
+            size_t getRows() const;
+            size_t getCols() const;
+
+        private:
+            struct Workers
+            {
+                explicit Workers(size_t threads) : pool(threads) {}
+
+                ThreadPool pool;
+                std::mutex call;    // one product at a time
+                std::mutex mutex;
+                std::condition_variable done;
+                size_t pending = 0;
+                size_t chunk = 0;   // operands of the running product
+                const T* x = nullptr;
+                T* y = nullptr;
+            };
+
+            void multiplyRows(size_t lo, size_t hi, const T* x, T* y) const;
+            void runChunk(size_t lo) const; // on a worker
+
+        private:
+            size_t m_rows;
+            size_t m_cols;
+            size_t m_chunks;
+            std::vector<T> m_data;
+            std::shared_ptr<Workers> m_workers; // null if the product runs serially
+        };
+
+        template<class T>
+        DenseOperator<T>::DenseOperator(const Matrix<T>& a)
+            : m_rows(a.getRows())
+            , m_cols(a.getCols())
+            , m_chunks(detail::chunkCount(a.getRows(), detail::currentTuning().gemmGrainRows))
+            , m_data(detail::pack(a))
+        {
+            if (m_chunks > 1) {
+                m_workers = std::make_shared<Workers>(m_chunks - 1);
+            }
+        }
+
+        template<class T>
+        inline void DenseOperator<T>::multiplyRows(size_t lo, size_t hi, const T* x, T* y) const
+        {
+            for (size_t i = lo; i < hi; ++i) {
+                const T* row = m_data.data() + i * m_cols;
+                T sum = static_cast<T>(0);
+                for (size_t j = 0; j < m_cols; ++j) {
+                    sum += row[j] * x[j];
+                }
+                y[i] = sum;
+            }
+        }
+
+        /**
+        * @brief Chunk c covers the same rows as chunk c of parallelFor(), the calling thread
+        * takes chunk 0 and the workers the rest.
+        */
+
+        template<class T>
+        inline void DenseOperator<T>::operator()(const std::vector<T>& x, std::vector<T>& y) const
+        {
+            if (x.size() != m_cols) {
+                throw std::invalid_argument("Vector size must match the number of columns.");
+            }
+            y.resize(m_rows);
+            if (!m_workers) {
+                multiplyRows(0, m_rows, x.data(), y.data());
+                return;
+            }
+
+            Workers& workers = *m_workers;
+            std::lock_guard<std::mutex> call(workers.call);
+            const size_t chunk = (m_rows + m_chunks - 1) / m_chunks;
+            {
+                std::lock_guard<std::mutex> lock(workers.mutex);
+                workers.pending = (m_rows + chunk - 1) / chunk - 1;
+                workers.chunk = chunk;
+                workers.x = x.data();
+                workers.y = y.data();
+            }
+            for (size_t lo = chunk; lo < m_rows; lo += chunk) {
+                workers.pool.submit([this, lo]() { runChunk(lo); }); // small enough for std::function's inline buffer
+            }
+            multiplyRows(0, std::min(chunk, m_rows), x.data(), y.data());
+            std::unique_lock<std::mutex> lock(workers.mutex);
+            workers.done.wait(lock, [&workers]() { return workers.pending == 0; });
+        }
+
+        template<class T>
+        inline void DenseOperator<T>::runChunk(size_t lo) const
+        {
+            Workers& workers = *m_workers;
+            multiplyRows(lo, std::min(lo + workers.chunk, m_rows), workers.x, workers.y);
+            std::lock_guard<std::mutex> lock(workers.mutex);
+            if (--workers.pending == 0) {
+                workers.done.notify_one();
+            }
+        }
+
+        template<class T>
+        inline size_t DenseOperator<T>::getRows() const
+        {
+            return m_rows;
+        }
+
+        template<class T>
+        inline size_t DenseOperator<T>::getCols() const
+        {
+            return m_cols;
+        }
+
+
+        struct IdentityPreconditioner
+        {
+            template<class T>
+            void operator()(const std::vector<T>& r, std::vector<T>& z) const
+            {
+                std::copy(r.begin(), r.end(), z.begin());
+            }
+        };
+
+
+        /**
+         * @brief Jacobi preconditioner, z = D^-1 * r with D the diagonal of A.
+         * Built from the diagonal of A, as a DiagonalMatrix or a vector, the inverse is formed once.
+         */
+        template<class T>
+        class JacobiPreconditioner
+        {
+        public:
+            explicit JacobiPreconditioner(const DiagonalMatrix<T>& diagonal);
+            explicit JacobiPreconditioner(const std::vector<T>& diagonal);
+
+            void operator()(const std::vector<T>& r, std::vector<T>& z) const;
+
+        private:
+            std::vector<T> m_inverse;
+        };
+
+        template<class T>
+        JacobiPreconditioner<T>::JacobiPreconditioner(const DiagonalMatrix<T>& diagonal)
+            : JacobiPreconditioner(diagonal.getDiagonal())
+        {}
+
+        template<class T>
+        JacobiPreconditioner<T>::JacobiPreconditioner(const std::vector<T>& diagonal)
+            : m_inverse(diagonal.size())
+        {
+            for (size_t i = 0; i < diagonal.size(); ++i) {
+                if (diagonal[i] == static_cast<T>(0)) {
+                    throw std::invalid_argument("Jacobi preconditioner requires a nonzero diagonal!");
+                }
+                m_inverse[i] = static_cast<T>(1) / diagonal[i];
+            }
+        }
+
+        template<class T>
+        inline void JacobiPreconditioner<T>::operator()(const std::vector<T>& r, std::vector<T>& z) const
+        {
+            for (size_t i = 0; i < m_inverse.size(); ++i) {
+                z[i] = m_inverse[i] * r[i];
+            }
+        }
+
+
+        /**
+        * @brief Jacobi preconditioner from the diagonal of a dense matrix.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline JacobiPreconditioner<T> makeJacobi(const Matrix<T>& a)
+        {
+            if (a.getRows() != a.getCols()) {
+                throw std::invalid_argument("Jacobi preconditioner requires a square matrix!");
+            }
+            return JacobiPreconditioner<T>(a.getDiagonal());
+        }
+
+
+        namespace detail
+        {
+            // ////////////////////////////////////////////////////////////////////////////////////////
+            // Level 1 helpers of the Krylov solvers
+            // ////////////////////////////////////////////////////////////////////////////////////////
+
+            template<class T>
+            inline T dot(const std::vector<T>& x, const std::vector<T>& y)
+            {
+                T sum = static_cast<T>(0);
+                for (size_t i = 0; i < x.size(); ++i) {
+                    sum += x[i] * y[i];
+                }
+                return sum;
+            }
+
+            template<class T>
+            inline double norm2(const std::vector<T>& x)
+            {
+                return std::sqrt(static_cast<double>(dot(x, x)));
+            }
+
+            template<class T>
+            inline void axpy(T alpha, const std::vector<T>& x, std::vector<T>& y) // y += alpha * x
+            {
+                for (size_t i = 0; i < x.size(); ++i) {
+                    y[i] += alpha * x[i];
+                }
+            }
+
+            inline bool monitorStep(KrylovResult& result, const KrylovConfig& config, double residual)
+            {
+                result.residual = residual;
+                if (config.recordHistory) {
+                    result.history.push_back(residual);
+                }
+                if (residual <= config.tolerance) {
+                    result.converged = true;
+                    return false;
+                }
+                if (config.monitor && !config.monitor(result.iterations, residual)) {
+                    result.stopped = true;
+                    return false;
+                }
+                return true;
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Krylov solvers
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Preconditioned conjugate gradient for symmetric positive definite operators.
+        *
+        * Example usage:
+        * \code
+        * std::vector<double> x;
+        * auto result = NumeriCore::Matrix::conjugateGradient(DenseOperator<double>(A), b, x, KrylovConfig(), makeJacobi(A));
+        * \endcode
+        *
+        * @param a Operator computing y = A * x.
+        * @param b Right-hand side.
+        * @param x Initial guess on entry (resized and zeroed if its size does not match), solution on exit.
+        * @param config Stopping criteria and monitoring.
+        * @param preconditioner Callable computing z = M^-1 * r.
+        * @param workspace Optional vector pool reused across solves.
+        * @return Iterations, final relative residual and termination reason.
+        * @tparam T Type of vector elements.
+        */
+
+        template<class T, class Operator, class Preconditioner = IdentityPreconditioner>
+        inline KrylovResult conjugateGradient(const Operator& a, const std::vector<T>& b, std::vector<T>& x,
+                                              const KrylovConfig& config = KrylovConfig(),
+                                              const Preconditioner& preconditioner = Preconditioner(),
+                                              KrylovWorkspace<T>* workspace = nullptr)
+        {
+            KrylovResult result;
+            KrylovWorkspace<T> local;
+            KrylovWorkspace<T>& pool = workspace != nullptr ? *workspace : local;
+            const size_t n = b.size();
+            if (x.size() != n) {
+                x.assign(n, static_cast<T>(0));
+            }
+
+            const double bnorm = detail::norm2(b);
+            if (bnorm == 0.0) {
+                std::fill(x.begin(), x.end(), static_cast<T>(0));
+                result.converged = true;
+                return result;
+            }
+
+            std::vector<T>& r = pool.get(0, n);
+            std::vector<T>& z = pool.get(1, n);
+            std::vector<T>& p = pool.get(2, n);
+            std::vector<T>& q = pool.get(3, n);
+
+            a(x, q);
+            for (size_t i = 0; i < n; ++i) {
+                r[i] = b[i] - q[i];
+            }
+            if (!detail::monitorStep(result, config, detail::norm2(r) / bnorm)) {
+                return result;
+            }
+
+            preconditioner(r, z);
+            std::copy(z.begin(), z.end(), p.begin());
+            T rz = detail::dot(r, z);
+
+            while (result.iterations < config.maxIterations) {
+                a(p, q);
+                const T pq = detail::dot(p, q);
+                if (pq == static_cast<T>(0)) {
+                    result.breakdown = true;
+                    break;
+                }
+                const T alpha = rz / pq;
+                detail::axpy(alpha, p, x);
+                detail::axpy(-alpha, q, r);
+                result.iterations++;
+                if (!detail::monitorStep(result, config, detail::norm2(r) / bnorm)) {
+                    break;
+                }
+
+                preconditioner(r, z);
+                const T rzNext = detail::dot(r, z);
+                const T beta = rzNext / rz;
+                rz = rzNext;
+                for (size_t i = 0; i < n; ++i) {
+                    p[i] = z[i] + beta * p[i];
+                }
+            }
+            return result;
+        }
+
+
+        /**
+        * @brief Right-preconditioned BiCGSTAB for general nonsymmetric operators.
+        * Parameters as for conjugateGradient().
+        * @tparam T Type of vector elements.
+        */
+
+        template<class T, class Operator, class Preconditioner = IdentityPreconditioner>
+        inline KrylovResult biCGSTAB(const Operator& a, const std::vector<T>& b, std::vector<T>& x,
+                                     const KrylovConfig& config = KrylovConfig(),
+                                     const Preconditioner& preconditioner = Preconditioner(),
+                                     KrylovWorkspace<T>* workspace = nullptr)
+        {
+            KrylovResult result;
+            KrylovWorkspace<T> local;
+            KrylovWorkspace<T>& pool = workspace != nullptr ? *workspace : local;
+            const size_t n = b.size();
+            if (x.size() != n) {
+                x.assign(n, static_cast<T>(0));
+            }
+
+            const double bnorm = detail::norm2(b);
+            if (bnorm == 0.0) {
+                std::fill(x.begin(), x.end(), static_cast<T>(0));
+                result.converged = true;
+                return result;
+            }
+
+            std::vector<T>& r = pool.get(0, n);
+            std::vector<T>& rHat = pool.get(1, n);
+            std::vector<T>& p = pool.get(2, n);
+            std::vector<T>& v = pool.get(3, n);
+            std::vector<T>& y = pool.get(4, n);
+            std::vector<T>& s = pool.get(5, n);
+            std::vector<T>& t = pool.get(6, n);
+
+            a(x, v);
+            for (size_t i = 0; i < n; ++i) {
+                r[i] = b[i] - v[i];
+            }
+            if (!detail::monitorStep(result, config, detail::norm2(r) / bnorm)) {
+                return result;
+            }
+
+            std::copy(r.begin(), r.end(), rHat.begin());
+            std::fill(p.begin(), p.end(), static_cast<T>(0));
+            std::fill(v.begin(), v.end(), static_cast<T>(0));
+            T rho = static_cast<T>(1);
+            T alpha = static_cast<T>(1);
+            T omega = static_cast<T>(1);
+
+            while (result.iterations < config.maxIterations) {
+                const T rhoNext = detail::dot(rHat, r);
+                if (rhoNext == static_cast<T>(0) || omega == static_cast<T>(0)) {
+                    result.breakdown = true;
+                    break;
+                }
+                const T beta = (rhoNext / rho) * (alpha / omega);
+                rho = rhoNext;
+                for (size_t i = 0; i < n; ++i) {
+                    p[i] = r[i] + beta * (p[i] - omega * v[i]);
+                }
+
+                preconditioner(p, y);
+                a(y, v);
+                const T rv = detail::dot(rHat, v);
+                if (rv == static_cast<T>(0)) {
+                    result.breakdown = true;
+                    break;
+                }
+                alpha = rho / rv;
+                for (size_t i = 0; i < n; ++i) {
+                    s[i] = r[i] - alpha * v[i];
+                }
+                detail::axpy(alpha, y, x);
+                result.iterations++;
+
+                const double sNorm = detail::norm2(s) / bnorm;
+                if (sNorm <= config.tolerance) {
+                    detail::monitorStep(result, config, sNorm);
+                    break;
+                }
+
+                preconditioner(s, y);
+                a(y, t);
+                const T tt = detail::dot(t, t);
+                omega = tt == static_cast<T>(0) ? static_cast<T>(0) : detail::dot(t, s) / tt;
+                detail::axpy(omega, y, x);
+                for (size_t i = 0; i < n; ++i) {
+                    r[i] = s[i] - omega * t[i];
+                }
+                if (!detail::monitorStep(result, config, detail::norm2(r) / bnorm)) {
+                    break;
+                }
+            }
+            return result;
+        }
+
+
+        /**
+        * @brief Right-preconditioned restarted GMRES(m) for general nonsymmetric operators.
+        * Builds an Arnoldi basis with modified Gram-Schmidt and keeps the least-squares problem
+        * triangular with Givens rotations, so the residual norm is known in every iteration without
+        * forming x. config.restart sets m. Parameters as for conjugateGradient().
+        * @tparam T Type of vector elements.
+        */
+
+        template<class T, class Operator, class Preconditioner = IdentityPreconditioner>
+        inline KrylovResult gmres(const Operator& a, const std::vector<T>& b, std::vector<T>& x,
+                                  const KrylovConfig& config = KrylovConfig(),
+                                  const Preconditioner& preconditioner = Preconditioner(),
+                                  KrylovWorkspace<T>* workspace = nullptr)
+        {
+            KrylovResult result;
+            KrylovWorkspace<T> local;
+            KrylovWorkspace<T>& pool = workspace != nullptr ? *workspace : local;
+            const size_t n = b.size();
+            const size_t m = std::max<size_t>(config.restart, 1);
+            if (x.size() != n) {
+                x.assign(n, static_cast<T>(0));
+            }
+
+            const double bnorm = detail::norm2(b);
+            if (bnorm == 0.0) {
+                std::fill(x.begin(), x.end(), static_cast<T>(0));
+                result.converged = true;
+                return result;
+            }
+
+            std::vector<T>& w = pool.get(0, n);
+            std::vector<T>& z = pool.get(1, n);
+            std::vector<T>& h = pool.get(2, (m + 1) * m);
+            std::vector<T>& cs = pool.get(3, m);
+            std::vector<T>& sn = pool.get(4, m);
+            std::vector<T>& g = pool.get(5, m + 1);
+            std::vector<T>& y = pool.get(6, m);
+            std::vector<std::vector<T>*> basis(m + 1);
+            for (size_t i = 0; i <= m; ++i) {
+                basis[i] = &pool.get(7 + i, n);
+            }
+
+            while (true) {
+                std::vector<T>& v0 = *basis[0];
+                a(x, w);
+                for (size_t i = 0; i < n; ++i) {
+                    v0[i] = b[i] - w[i];
+                }
+                const double beta = detail::norm2(v0);
+                if (!detail::monitorStep(result, config, beta / bnorm) || result.iterations >= config.maxIterations) {
+                    break;
+                }
+                for (auto& element : v0) {
+                    element /= static_cast<T>(beta);
+                }
+                std::fill(g.begin(), g.end(), static_cast<T>(0));
+                g[0] = static_cast<T>(beta);
+
+                size_t k = 0;
+                bool proceed = true;
+                while (k < m && result.iterations < config.maxIterations && proceed) {
+                    preconditioner(*basis[k], z);
+                    a(z, w);
+                    for (size_t i = 0; i <= k; ++i) {
+                        const T hik = detail::dot(w, *basis[i]);
+                        h[i * m + k] = hik;
+                        detail::axpy(-hik, *basis[i], w);
+                    }
+                    const T next = static_cast<T>(detail::norm2(w));
+                    h[(k + 1) * m + k] = next;
+                    if (next != static_cast<T>(0)) {
+                        for (size_t i = 0; i < n; ++i) {
+                            (*basis[k + 1])[i] = w[i] / next;
+                        }
+                    }
+
+                    for (size_t i = 0; i < k; ++i) {
+                        const T upper = h[i * m + k];
+                        const T lower = h[(i + 1) * m + k];
+                        h[i * m + k] = cs[i] * upper + sn[i] * lower;
+                        h[(i + 1) * m + k] = -sn[i] * upper + cs[i] * lower;
+                    }
+                    const T denom = std::hypot(h[k * m + k], next);
+                    if (denom == static_cast<T>(0)) {
+                        result.breakdown = true;
+                        break;
+                    }
+                    cs[k] = h[k * m + k] / denom;
+                    sn[k] = next / denom;
+                    h[k * m + k] = denom;
+                    h[(k + 1) * m + k] = static_cast<T>(0);
+                    g[k + 1] = -sn[k] * g[k];
+                    g[k] = cs[k] * g[k];
+
+                    k++;
+                    result.iterations++;
+                    proceed = detail::monitorStep(result, config, std::abs(static_cast<double>(g[k])) / bnorm)
+                           && next != static_cast<T>(0);
+                }
+
+                // x += M^-1 * V * y with H y = g
+                for (size_t step = 0; step < k; ++step) {
+                    const size_t i = k - 1 - step;
+                    T sum = g[i];
+                    for (size_t j = i + 1; j < k; ++j) {
+                        sum -= h[i * m + j] * y[j];
+                    }
+                    y[i] = sum / h[i * m + i];
+                }
+                std::fill(w.begin(), w.end(), static_cast<T>(0));
+                for (size_t i = 0; i < k; ++i) {
+                    detail::axpy(y[i], *basis[i], w);
+                }
+                preconditioner(w, z);
+                detail::axpy(static_cast<T>(1), z, x);
+
+                if (result.converged || result.stopped || result.breakdown || result.iterations >= config.maxIterations) {
+                    break;
+                }
+            }
+            return result;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Dense matrix overloads
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T, class Preconditioner = IdentityPreconditioner>
+        inline KrylovResult conjugateGradient(const Matrix<T>& a, const std::vector<T>& b, std::vector<T>& x,
+                                              const KrylovConfig& config = KrylovConfig(),
+                                              const Preconditioner& preconditioner = Preconditioner(),
+                                              KrylovWorkspace<T>* workspace = nullptr)
+        {
+            return conjugateGradient(DenseOperator<T>(a), b, x, config, preconditioner, workspace);
+        }
+
+        template<class T, class Preconditioner = IdentityPreconditioner>
+        inline KrylovResult biCGSTAB(const Matrix<T>& a, const std::vector<T>& b, std::vector<T>& x,
+                                     const KrylovConfig& config = KrylovConfig(),
+                                     const Preconditioner& preconditioner = Preconditioner(),
+                                     KrylovWorkspace<T>* workspace = nullptr)
+        {
+            return biCGSTAB(DenseOperator<T>(a), b, x, config, preconditioner, workspace);
+        }
+
+        template<class T, class Preconditioner = IdentityPreconditioner>
+        inline KrylovResult gmres(const Matrix<T>& a, const std::vector<T>& b, std::vector<T>& x,
+                                  const KrylovConfig& config = KrylovConfig(),
+                                  const Preconditioner& preconditioner = Preconditioner(),
+                                  KrylovWorkspace<T>* workspace = nullptr)
+        {
+            return gmres(DenseOperator<T>(a), b, x, config, preconditioner, workspace);
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __KRYLOV_HPP__ */
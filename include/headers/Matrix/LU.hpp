@@ -0,0 +1,365 @@
+#ifndef __LU_HPP__
+#define __LU_HPP__
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief LU factorization P * A = L * U with partial pivoting.
+         * L is unit lower and U upper triangular, both kept in one dense buffer. Once factored, a
+         * right-hand side costs O(n^2) and a rank-k change A + U * V^T costs O(n^2 k) through
+         * update() instead of a new O(n^3) factorization.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::LU<double> lu(a);
+         * auto x = lu.solve(b);
+         * lu.update(u, v);  // now factors a + u * v^T
+         * \endcode
+         */
+        template<class T>
+        class LU
+        {
+        public:
+            explicit LU(const Matrix<T>& a);
+
+            ~LU() = default;
+
+        public:
+            Matrix<T> solve(const Matrix<T>& b) const; // solve A * x = b
+            Matrix<T> inverse() const; // A^-1
+            T determinant() const; // det(A)
+            Matrix<T> getL() const; // unit lower triangular factor
+            Matrix<T> getU() const; // upper triangular factor
+            const std::vector<size_t>& getPermutation() const; // row i of P * A is row perm[i] of A
+            size_t getSize() const; // order of A
+
+            bool update(const Matrix<T>& u, const Matrix<T>& v); // factor A + u * v^T instead
+
+        private:
+            void factorize();
+            bool rankOne(std::vector<T>& x, std::vector<T>& y);
+            std::vector<T> reconstruct() const;
+
+        private:
+            size_t m_size = 0;
+            std::vector<T> m_lu; // L below the diagonal, U on and above it, row-major
+            std::vector<size_t> m_perm;
+            int m_sign = 1; // sign of the permutation
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // LU class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Factorizes a square matrix.
+         * @throw std::invalid_argument If a is not square.
+         * @throw std::runtime_error If a is singular.
+         * @tparam T Type of matrix elements.
+         */
+
+        template<class T>
+        LU<T>::LU(const Matrix<T>& a)
+            : m_size(a.getRows())
+        {
+            if (a.getRows() != a.getCols()) {
+                throw std::invalid_argument("LU factorization requires a square matrix!");
+            }
+            m_lu = detail::pack(a);
+            factorize();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // LU class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief Right-looking elimination of m_lu in place, the rank-1 update of the trailing rows
+         * runs in parallel.
+         */
+
+        template<class T>
+        void LU<T>::factorize()
+        {
+            const size_t n = m_size;
+            T* A = m_lu.data();
+            const size_t grain = detail::currentTuning().gemmGrainRows;
+            m_perm.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                m_perm[i] = i;
+            }
+            m_sign = 1;
+
+            for (size_t k = 0; k < n; ++k) {
+                size_t pivot = k;
+                for (size_t i = k + 1; i < n; ++i) {
+                    if (std::abs(A[i * n + k]) > std::abs(A[pivot * n + k])) {
+                        pivot = i;
+                    }
+                }
+                if (A[pivot * n + k] == static_cast<T>(0)) {
+                    throw std::runtime_error("Matrix is singular.");
+                }
+                if (pivot != k) {
+                    std::swap_ranges(A + k * n, A + (k + 1) * n, A + pivot * n);
+                    std::swap(m_perm[k], m_perm[pivot]);
+                    m_sign = -m_sign;
+                }
+
+                const T* ak = A + k * n;
+                detail::parallelFor(k + 1, n, grain, [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        T* ai = A + i * n;
+                        const T l = ai[k] / ak[k];
+                        ai[k] = l;
+                        for (size_t j = k + 1; j < n; ++j) {
+                            ai[j] -= l * ak[j];
+                        }
+                    }
+                });
+            }
+        }
+
+        /**
+        * @brief Solves A * x = b by permuting b and two triangular solves.
+        * @throws std::invalid_argument if b has the wrong number of rows.
+        */
+
+        template<class T>
+        Matrix<T> LU<T>::solve(const Matrix<T>& b) const
+        {
+            if (b.getRows() != m_size) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the factorized matrix.");
+            }
+            const size_t r = b.getCols();
+            std::vector<T> x(m_size * r);
+            for (size_t i = 0; i < m_size; ++i) {
+                std::copy(b.rowData(m_perm[i]), b.rowData(m_perm[i]) + r, x.begin() + i * r);
+            }
+            const detail::DenseRows<const T> rows{ m_lu.data(), m_size };
+
+            detail::parallelFor(0, r, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::trsmLeft(true, true, m_size, hi - lo, rows, x.data() + lo, r);
+                detail::trsmLeft(false, false, m_size, hi - lo, rows, x.data() + lo, r);
+            });
+
+            Matrix<T> result(m_size, r, zeroFill);
+            detail::unpack(x.data(), r, result);
+            return result;
+        }
+
+        template<class T>
+        Matrix<T> LU<T>::inverse() const
+        {
+            Matrix<T> identity(m_size, m_size, zeroFill);
+            for (size_t i = 0; i < m_size; ++i) {
+                identity.rowData(i)[i] = static_cast<T>(1);
+            }
+            return solve(identity);
+        }
+
+        template<class T>
+        T LU<T>::determinant() const
+        {
+            T result = static_cast<T>(m_sign);
+            for (size_t i = 0; i < m_size; ++i) {
+                result *= m_lu[i * m_size + i];
+            }
+            return result;
+        }
+
+        template<class T>
+        Matrix<T> LU<T>::getL() const
+        {
+            Matrix<T> result(m_size, m_size, zeroFill);
+            for (size_t i = 0; i < m_size; ++i) {
+                T* row = result.rowData(i);
+                for (size_t j = 0; j < m_size; ++j) {
+                    row[j] = j < i ? m_lu[i * m_size + j] : static_cast<T>(j == i ? 1 : 0);
+                }
+            }
+            return result;
+        }
+
+        template<class T>
+        Matrix<T> LU<T>::getU() const
+        {
+            Matrix<T> result(m_size, m_size, zeroFill);
+            for (size_t i = 0; i < m_size; ++i) {
+                T* row = result.rowData(i);
+                for (size_t j = 0; j < m_size; ++j) {
+                    row[j] = j >= i ? m_lu[i * m_size + j] : static_cast<T>(0);
+                }
+            }
+            return result;
+        }
+
+        template<class T>
+        const std::vector<size_t>& LU<T>::getPermutation() const
+        {
+            return m_perm;
+        }
+
+        template<class T>
+        size_t LU<T>::getSize() const
+        {
+            return m_size;
+        }
+
+        /**
+        * @brief Rank-1 update of L * U to L * U + x * y^T in O(n^2) (Bennett's algorithm).
+        * Step k fixes row k of U and column k of L and leaves the rank-1 term
+        * x~ y~^T for the trailing block:
+        *      d' = u_kk + x_k y_k,   u_kj += x_k y_j,   l_ik = (l_ik u_kk + x_i y_k) / d'
+        *      x~_i = x_i - x_k l_ik, y~_j = (u_kk y_j - y_k u_kj) / d'
+        * There is no pivoting, so a pivot that cancels to less than sqrt(eps) of its terms is
+        * reported as failure. The factors are then partly updated and must be restored.
+        */
+
+        template<class T>
+        bool LU<T>::rankOne(std::vector<T>& x, std::vector<T>& y)
+        {
+            const size_t n = m_size;
+            T* A = m_lu.data();
+            const auto tolerance = std::sqrt(std::numeric_limits<decltype(std::abs(T{}))>::epsilon());
+
+            for (size_t k = 0; k < n; ++k) {
+                const T a = x[k];
+                const T b = y[k];
+                const T d = A[k * n + k];
+                const T pivot = d + a * b;
+                if (!(std::abs(pivot) > tolerance * std::max(std::abs(d), std::abs(a * b)))) {
+                    return false;
+                }
+                A[k * n + k] = pivot;
+                T* uk = A + k * n;
+                for (size_t j = k + 1; j < n; ++j) {
+                    const T u = uk[j];
+                    uk[j] = u + a * y[j];
+                    y[j] = (d * y[j] - b * u) / pivot;
+                }
+                for (size_t i = k + 1; i < n; ++i) {
+                    T& l = A[i * n + k];
+                    const T old = l;
+                    l = (old * d + x[i] * b) / pivot;
+                    x[i] -= a * old;
+                }
+            }
+            return true;
+        }
+
+        // P^T * L * U, used when an update has to fall back to a new factorization.
+        template<class T>
+        std::vector<T> LU<T>::reconstruct() const
+        {
+            const size_t n = m_size;
+            std::vector<T> l(n * n, static_cast<T>(0));
+            std::vector<T> u(n * n, static_cast<T>(0));
+            for (size_t i = 0; i < n; ++i) {
+                std::copy(m_lu.begin() + i * n, m_lu.begin() + i * n + i, l.begin() + i * n);
+                l[i * n + i] = static_cast<T>(1);
+                std::copy(m_lu.begin() + i * n + i, m_lu.begin() + (i + 1) * n, u.begin() + i * n + i);
+            }
+            std::vector<T> pa(n * n);
+            detail::parallelFor(0, n, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::gemm(hi - lo, n, n, l.data() + lo * n, n, u.data(), n, pa.data() + lo * n, n);
+            });
+            std::vector<T> a(n * n);
+            for (size_t i = 0; i < n; ++i) {
+                std::copy(pa.begin() + i * n, pa.begin() + (i + 1) * n, a.begin() + m_perm[i] * n);
+            }
+            return a;
+        }
+
+        /**
+        * @brief Replaces the factorization of A by one of A + u * v^T.
+        * Each column pair is applied as a rank-1 update of the permuted system
+        * P * (A + u v^T) = L * U + (P u) v^T, O(n^2) per column. The pivot order is kept, so if
+        * an update would divide by a cancelled pivot, the factors are restored and A + u * v^T is
+        * formed explicitly and refactored with fresh pivoting in O(n^3).
+        *
+        * @param u Left factor, n x k.
+        * @param v Right factor, n x k.
+        * @return true if the cheap update succeeded, false if a refactorization was needed.
+        * @throw std::invalid_argument If u and v are not both n x k.
+        * @throw std::runtime_error If the updated matrix is singular, the factorization of A is
+        * kept then.
+        */
+
+        template<class T>
+        bool LU<T>::update(const Matrix<T>& u, const Matrix<T>& v)
+        {
+            if (u.getRows() != m_size || v.getRows() != m_size || u.getCols() != v.getCols()) {
+                throw std::invalid_argument("Update factors must both be n x k!");
+            }
+            const size_t n = m_size;
+            const size_t k = u.getCols();
+            const std::vector<T> saved = m_lu;
+
+            std::vector<T> x(n);
+            std::vector<T> y(n);
+            for (size_t c = 0; c < k; ++c) {
+                for (size_t i = 0; i < n; ++i) {
+                    x[i] = u.rowData(m_perm[i])[c];
+                    y[i] = v.rowData(i)[c];
+                }
+                if (!rankOne(x, y)) {
+                    m_lu = saved;
+                    std::vector<T> a = reconstruct();
+                    for (size_t i = 0; i < n; ++i) {
+                        for (size_t p = 0; p < k; ++p) {
+                            const T up = u.rowData(i)[p];
+                            for (size_t j = 0; j < n; ++j) {
+                                a[i * n + j] += up * v.rowData(j)[p];
+                            }
+                        }
+                    }
+                    const std::vector<size_t> perm = m_perm;
+                    const int sign = m_sign;
+                    m_lu = std::move(a);
+                    try {
+                        factorize();
+                    }
+                    catch (...) {
+                        m_lu = saved;
+                        m_perm = perm;
+                        m_sign = sign;
+                        throw;
+                    }
+                    return false;
+                }
+            }
+            return true;
+        }
+
+
+        /**
+        * @brief Replaces the matrix by its inverse, computed through an LU factorization.
+        * @throw std::invalid_argument If the matrix is not square.
+        * @throw std::runtime_error If the matrix is singular.
+        */
+
+        template<class T>
+        void Matrix<T>::inverse()
+        {
+            (*this) = LU<T>(*this).inverse();
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __LU_HPP__ */
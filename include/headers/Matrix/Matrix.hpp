@@ -7,12 +7,91 @@
 #include <math.h> 
 #include <iomanip>
 #include <random> 
+#include <mutex>
+#include <cstdint>
+#include <complex>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "Parallel.hpp"
+#include "PropertyCache.hpp"
+#include "MatrixIterators.hpp"
 
 
 namespace NumeriCore 
 {
     namespace Matrix 
     {                    
+        namespace detail
+        {
+            /**
+            * @brief Distribution behind the random constructor, values in [-2000, 5000].
+            * Real types draw from a real distribution, integral types from an integer one clipped
+            * to the range of T, std::complex draws its real and imaginary parts independently.
+            */
+            template<class T, class = void>
+            struct UniformElement
+            {
+                std::uniform_real_distribution<T> dis{ -2000, 5000 };
+
+                template<class Generator>
+                T operator()(Generator& gen) { return dis(gen); }
+            };
+
+            template<class T>
+            struct UniformElement<T, std::enable_if_t<std::is_integral_v<T>>>
+            {
+                std::uniform_int_distribution<long long> dis{
+                    std::max<long long>(-2000, static_cast<long long>(std::numeric_limits<T>::lowest())),
+                    std::min<long long>(5000, static_cast<long long>(std::numeric_limits<T>::max())) };
+
+                template<class Generator>
+                T operator()(Generator& gen) { return static_cast<T>(dis(gen)); }
+            };
+
+            template<class R>
+            struct UniformElement<std::complex<R>>
+            {
+                UniformElement<R> part;
+
+                template<class Generator>
+                std::complex<R> operator()(Generator& gen)
+                {
+                    const R re = part(gen);
+                    return std::complex<R>(re, part(gen));
+                }
+            };
+
+            // Width of a number as the stream operator prints it, used to align matrix columns.
+            template<class T>
+            int printedWidth(const T& number)
+            {
+                return static_cast<int>(std::to_string(number).length());
+            }
+
+            template<class R>
+            int printedWidth(const std::complex<R>& number)
+            {
+                return printedWidth(number.real()) + printedWidth(number.imag()) + 3; // "(re,im)"
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Tag of the shape constructor Matrix<T>(rows, cols, zeroFill), which sets every
+        * element to zero instead of drawing random values. Meant for destinations that are
+        * overwritten right away.
+        */
+        struct ZeroFill
+        {
+            explicit ZeroFill() = default;
+        };
+
+        inline constexpr ZeroFill zeroFill{};
+
+
         template<class T> 
         class Matrix
         {
@@ -24,6 +103,7 @@ namespace NumeriCore
             
             Matrix() = default; 
             Matrix(size_t _rows, size_t _cols, std::string _name = "Unkown");  
+            Matrix(size_t _rows, size_t _cols, ZeroFill, std::string _name = "Unkown"); // all elements zero
             Matrix(const std::initializer_list<std::initializer_list<T>>& _list, std::string _name = "Unkown"); 
 
             ~Matrix() = default;
@@ -74,30 +154,76 @@ namespace NumeriCore
             
             T getElement(size_t row, size_t col) const; // get element at index row, column
             T& getElement(size_t row, size_t col); // get reference to element at index row
+            const T* rowData(size_t row) const; // contiguous elements of a row, unchecked
+            T* rowData(size_t row); // contiguous elements of a row, unchecked
+
+            // //////////////////////////////////////////////////////////////////////////////////////////
+            //  Matix class element access and iterators
+            // //////////////////////////////////////////////////////////////////////////////////////////
 
-            void saveDiagonal(); // save diagonal of matrix in m_diagonal 
-            void printDiagonal(); // print diagonal of matrix in m_diagonal 
-            std::vector<T> getDiagonal() const; // get diagonal of matrix 
+            using iterator = detail::ElementIterator<T>;
+            using const_iterator = detail::ElementIterator<const T>;
+
+            T& operator()(size_t row, size_t col); // element reference, checked unless NDEBUG
+            const T& operator()(size_t row, size_t col) const; // element reference, checked unless NDEBUG
+            T& at(size_t row, size_t col); // element reference, always checked
+            const T& at(size_t row, size_t col) const; // element reference, always checked
+
+            iterator begin(); // all elements in row-major order
+            iterator end();
+            const_iterator begin() const;
+            const_iterator end() const;
+            const_iterator cbegin() const;
+            const_iterator cend() const;
+
+            RowView<T> row(size_t row); // contiguous view of one row
+            RowView<const T> row(size_t row) const;
+            ColumnView<T> column(size_t col); // strided view of one column
+            ColumnView<const T> column(size_t col) const;
+            IteratorRange<detail::ViewIterator<T, true>> rows(); // views of all rows
+            IteratorRange<detail::ViewIterator<const T, true>> rows() const;
+            IteratorRange<detail::ViewIterator<T, false>> columns(); // views of all columns
+            IteratorRange<detail::ViewIterator<const T, false>> columns() const;
+
+            void saveDiagonal(); // precompute the cached diagonal
+            void printDiagonal(); // print diagonal of matrix
+            std::vector<T> getDiagonal() const; // get diagonal of matrix, cached
+
+            bool isSymmetric() const; // cached
+            bool isLowerTriangular() const; // cached
+            bool isUpperTriangular() const; // cached
+            bool isDiagonal() const; // cached
+
+            uint64_t getVersion() const; // content stamp, replaced by mutations after it was observed
+            void markModified(); // invalidate cached properties after writing through kept references
 
             // //////////////////////////////////////////////////////////////////////////////////////////
             //  Matix class fgetters , setters and printerts
             // //////////////////////////////////////////////////////////////////////////////////////////
            
             void transpose(); // traspose matrix
-            void inverse();
+            void inverse(); // replace by the inverse, needs LU.hpp
            
 
 
         protected:
             void setElement(size_t row, size_t col, T element); // set element at index row, column
             void reserve(size_t value); // reserve memory for matrix
+            void setName(const std::string& name); // set name of matrix
+
+        private:
+            template<class V, class F>
+            V cached(detail::CacheSlot<V>& slot, F compute) const; // slot value for the current stamp
+
+            friend struct detail::PropertyAccess;
 
         private: 
-            std::vector<T> m_diagonal;
             std::string m_name = "Unknown"; 
-            size_t m_rows; 
-            size_t m_cols; 
+            size_t m_rows = 0; 
+            size_t m_cols = 0; 
             std::vector<std::vector<T>> m_elements; 
+            uint64_t m_stamp = detail::nextStamp();
+            mutable detail::PropertyCache<T> m_cache;
         }; // end class Matrix
 
 
@@ -141,13 +267,15 @@ namespace NumeriCore
                 std::vector<T> tempRow(row.begin(), row.end());
                 m_elements.push_back(tempRow);
             } 
-
-            saveDiagonal(); 
         } 
 
     
         /**
          * @brief Matrix random initialization constructor
+         * Rows are allocated and filled with the row partition of the row-band kernels
+         * (detail::placementGrainRows), so on NUMA systems each row block is first touched, and
+         * placed, on the node that later processes it.
+         *
          * @param _rows Number of rows in the matrix.
          * @param _cols Number of columns in the matrix.
          * @param _name Name of the matrix (default is "Unknown").
@@ -161,19 +289,48 @@ namespace NumeriCore
             , m_cols(_cols)
         {
             std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<T> dis(-2000, 5000);
+            const auto seed = rd();
 
-           // Resize m_elements to the correct dimensions
-            m_elements.resize(m_rows, std::vector<T>(m_cols));
+            m_elements.resize(m_rows);
 
-            // Fill the matrix with random values
-            for (size_t i = 0; i < m_rows; ++i) {
-                for (size_t j = 0; j < m_cols; ++j) {
-                    m_elements[i][j] = static_cast<T>(dis(gen));
+            detail::parallelFor(0, m_rows, detail::placementGrainRows(m_rows, m_cols), [&](size_t lo, size_t hi) {
+                std::seed_seq sequence{ seed, static_cast<std::uint32_t>(lo) };
+                std::mt19937 gen(sequence);
+                detail::UniformElement<T> dis;
+
+                for (size_t i = lo; i < hi; ++i) {
+                    m_elements[i].resize(m_cols);
+                    for (size_t j = 0; j < m_cols; ++j) {
+                        m_elements[i][j] = dis(gen);
+                    }
                 }
-            }
-            saveDiagonal(); 
+            });
+        }
+
+
+        /**
+         * @brief Matrix zero initialization constructor
+         * No random numbers are drawn. Rows are allocated with the same partition as in the random
+         * constructor, detail::placementGrainRows(), so first touch places them the same way.
+         *
+         * @param _rows Number of rows in the matrix.
+         * @param _cols Number of columns in the matrix.
+         * @param _name Name of the matrix (default is "Unknown").
+         * @tparam T Type of matrix elements.
+         */
+
+        template<class T>
+        inline Matrix<T>::Matrix(size_t _rows, size_t _cols, ZeroFill, std::string _name)
+            : m_name(_name)
+            , m_rows(_rows)
+            , m_cols(_cols)
+        {
+            m_elements.resize(m_rows);
+            detail::parallelFor(0, m_rows, detail::placementGrainRows(m_rows, m_cols), [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    m_elements[i].assign(m_cols, static_cast<T>(0));
+                }
+            });
         }
 
 
@@ -196,6 +353,7 @@ namespace NumeriCore
                     throw std::invalid_argument("Matrices must have the same dimensions.");
                 }
 
+            markModified();
             for (size_t i = 0; i < m_rows; ++i) {
                 for (size_t j = 0; j < m_cols; ++j) {
                     m_elements[i][j] += m1.m_elements[i][j];
@@ -220,6 +378,7 @@ namespace NumeriCore
                     throw std::invalid_argument("Matrices must have the same dimensions.");
                 }
 
+            markModified();
             for (size_t i = 0; i < m_rows; ++i) {
                 for (size_t j = 0; j < m_cols; ++j) {
                     m_elements[i][j] -= m1.m_elements[i][j];
@@ -244,6 +403,7 @@ namespace NumeriCore
                     throw std::invalid_argument("Matrices must have the same dimensions.");
                 }
 
+            markModified();
             for (size_t i = 0; i < m_rows; ++i) {
                 for (size_t j = 0; j < m_cols; ++j) {
                     m_elements[i][j] *= m1.m_elements[i][j];
@@ -408,6 +568,7 @@ namespace NumeriCore
         template<class T>
         inline Matrix<T>& Matrix<T>::operator+=(const T& scalar)
         {
+            markModified();
             for (size_t i = 0; i < m_rows; ++i) {
                 for (size_t j = 0; j < m_cols; ++j) {
                     m_elements[i][j] += scalar;
@@ -428,6 +589,7 @@ namespace NumeriCore
         template<class T>
         inline Matrix<T>& Matrix<T>::operator-=(const T& scalar)
         {
+            markModified();
             for (size_t i = 0; i < m_rows; ++i) {
                 for (size_t j = 0; j < m_cols; ++j) {
                     m_elements[i][j] -= scalar;
@@ -447,6 +609,7 @@ namespace NumeriCore
         template<class T>
         inline Matrix<T>& Matrix<T>::operator*=(const T& scalar)
         {
+            markModified();
             for (size_t i = 0; i < m_rows; ++i) {
                 for (size_t j = 0; j < m_cols; ++j) {
                     m_elements[i][j] *= scalar;
@@ -516,7 +679,7 @@ namespace NumeriCore
                 int maxNumberWidth = 0;
                 for (const auto& row : matrix.m_elements) {
                     for (const auto& number : row) {
-                        int numberWidth = std::to_string(number).length();
+                        int numberWidth = detail::printedWidth(number);
                         maxNumberWidth = std::max(maxNumberWidth, numberWidth);
                     }
                 }
@@ -559,12 +722,14 @@ namespace NumeriCore
         template<class T> 
         void Matrix<T>::setCols(size_t cols)
         {
+            markModified();
             this->m_cols = cols;
         }
 
         template<class T> 
         void Matrix<T>::setRows(size_t rows) 
         {
+            markModified();
             this->m_rows = rows;
         }
 
@@ -582,19 +747,177 @@ namespace NumeriCore
         template<class T> 
         void Matrix<T>::setElement(size_t row, size_t col, T element)
         {
-            m_elements.at(row).at(col) = element;
+            T& target = DefaultAccess::get(m_elements, row, col);
+            markModified();
+            target = element;
         }
 
         template<class T> 
         T Matrix<T>::getElement(size_t row, size_t col) const
         {
-            return static_cast<T>(m_elements.at(row).at(col));
+            return static_cast<T>(DefaultAccess::get(m_elements, row, col));
         }
 
         template<class T> 
         T& Matrix<T>::getElement(size_t row, size_t col) 
         {
-            return m_elements.at(row).at(col);
+            T& element = DefaultAccess::get(m_elements, row, col);
+            markModified();
+            return element;
+        }
+
+        template<class T> 
+        const T* Matrix<T>::rowData(size_t row) const
+        {
+            return m_elements[row].data();
+        }
+
+        template<class T> 
+        T* Matrix<T>::rowData(size_t row) 
+        {
+            markModified();
+            return m_elements[row].data();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Matix class element access and iterators
+        //
+        // getElement(), setElement(), operator() and row() follow DefaultAccess, at() always checks.
+        // Every non-const accessor below counts as a mutation for the property cache, writes
+        // through a view or iterator kept across a property query need markModified().
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        T& Matrix<T>::operator()(size_t row, size_t col)
+        {
+            T& element = DefaultAccess::get(m_elements, row, col);
+            markModified();
+            return element;
+        }
+
+        template<class T>
+        const T& Matrix<T>::operator()(size_t row, size_t col) const
+        {
+            return DefaultAccess::get(m_elements, row, col);
+        }
+
+        template<class T>
+        T& Matrix<T>::at(size_t row, size_t col)
+        {
+            T& element = CheckedAccess::get(m_elements, row, col);
+            markModified();
+            return element;
+        }
+
+        template<class T>
+        const T& Matrix<T>::at(size_t row, size_t col) const
+        {
+            return CheckedAccess::get(m_elements, row, col);
+        }
+
+        /**
+        * @brief Random-access iterator over all elements in row-major order.
+        * Works with the standard and parallel algorithms, e.g.
+        * \code
+        * std::transform(std::execution::par_unseq, m.begin(), m.end(), m.begin(), [](double x) { return x * x; });
+        * \endcode
+        */
+
+        template<class T>
+        typename Matrix<T>::iterator Matrix<T>::begin()
+        {
+            markModified();
+            return iterator(m_elements.data(), m_cols, 0);
+        }
+
+        template<class T>
+        typename Matrix<T>::iterator Matrix<T>::end()
+        {
+            markModified();
+            return iterator(m_elements.data(), m_cols, m_rows * m_cols);
+        }
+
+        template<class T>
+        typename Matrix<T>::const_iterator Matrix<T>::begin() const
+        {
+            return const_iterator(m_elements.data(), m_cols, 0);
+        }
+
+        template<class T>
+        typename Matrix<T>::const_iterator Matrix<T>::end() const
+        {
+            return const_iterator(m_elements.data(), m_cols, m_rows * m_cols);
+        }
+
+        template<class T>
+        typename Matrix<T>::const_iterator Matrix<T>::cbegin() const
+        {
+            return begin();
+        }
+
+        template<class T>
+        typename Matrix<T>::const_iterator Matrix<T>::cend() const
+        {
+            return end();
+        }
+
+        template<class T>
+        RowView<T> Matrix<T>::row(size_t row)
+        {
+            if constexpr (std::is_same_v<DefaultAccess, CheckedAccess>) {
+                m_elements.at(row);
+            }
+            markModified();
+            return RowView<T>(m_elements[row].data(), m_cols);
+        }
+
+        template<class T>
+        RowView<const T> Matrix<T>::row(size_t row) const
+        {
+            if constexpr (std::is_same_v<DefaultAccess, CheckedAccess>) {
+                m_elements.at(row);
+            }
+            return RowView<const T>(m_elements[row].data(), m_cols);
+        }
+
+        template<class T>
+        ColumnView<T> Matrix<T>::column(size_t col)
+        {
+            markModified();
+            return ColumnView<T>(m_elements.data(), col, m_rows);
+        }
+
+        template<class T>
+        ColumnView<const T> Matrix<T>::column(size_t col) const
+        {
+            return ColumnView<const T>(m_elements.data(), col, m_rows);
+        }
+
+        template<class T>
+        IteratorRange<detail::ViewIterator<T, true>> Matrix<T>::rows()
+        {
+            markModified();
+            return { { m_elements.data(), m_cols, 0 }, { m_elements.data(), m_cols, m_rows } };
+        }
+
+        template<class T>
+        IteratorRange<detail::ViewIterator<const T, true>> Matrix<T>::rows() const
+        {
+            return { { m_elements.data(), m_cols, 0 }, { m_elements.data(), m_cols, m_rows } };
+        }
+
+        template<class T>
+        IteratorRange<detail::ViewIterator<T, false>> Matrix<T>::columns()
+        {
+            markModified();
+            return { { m_elements.data(), m_rows, 0 }, { m_elements.data(), m_rows, m_cols } };
+        }
+
+        template<class T>
+        IteratorRange<detail::ViewIterator<const T, false>> Matrix<T>::columns() const
+        {
+            return { { m_elements.data(), m_rows, 0 }, { m_elements.data(), m_rows, m_cols } };
         }
 
 
@@ -604,45 +927,193 @@ namespace NumeriCore
             m_elements.reserve(value);
         }
 
+        template<class T> 
+        void Matrix<T>::setName(const std::string& name)
+        {
+            this->m_name = name;
+        }
+
+        /**
+        * @brief Fills the cached diagonal right away.
+        * Kept for existing callers, getDiagonal() computes it on first use anyway.
+        */
+
         template<class T> 
         void Matrix<T>::saveDiagonal() 
         {   
-            for (size_t i = 0; i < this->getRows(); i++) {
-                for (size_t j = 0; j < this->getCols(); j++) {
-                    if (i == j) {
-                        m_diagonal.push_back(m_elements.at(i).at(j));
-                    }
-                }
-            }
+            getDiagonal();
         }
 
         template<class T>
         void Matrix<T>::printDiagonal() 
         {
             std::cout << std::endl << "{ ";
-            for(auto element : m_diagonal) {
+            for(auto element : getDiagonal()) {
                 std::cout << element << ' ';
             }
             std::cout << "}\n";
         }
 
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Matix class cached properties
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Returns the entry of slot for the current contents, computing it first if it was
+        * made for an older stamp. Queries of unchanged matrices are O(1).
+        */
+
+        template<class T>
+        template<class V, class F>
+        V Matrix<T>::cached(detail::CacheSlot<V>& slot, F compute) const
+        {
+            std::lock_guard<std::mutex> lock(m_cache.mutex);
+            m_cache.observed.store(true, std::memory_order_relaxed);
+            if (slot.stamp != m_stamp) {
+                slot.value = compute();
+                slot.stamp = m_stamp;
+            }
+            return slot.value;
+        }
+
+        /**
+        * @brief Returns the content stamp of the matrix.
+        * Every mutation through the Matrix interface, including taking a non-const element
+        * reference or row pointer, moves the matrix to a new stamp, copies keep the stamp of their
+        * source. The stamp is a best-effort invalidation contract: a reference or row pointer
+        * taken before this call can still write without moving the stamp, so callers holding one
+        * must call markModified() after writing through it.
+        */
+
+        template<class T>
+        uint64_t Matrix<T>::getVersion() const
+        {
+            m_cache.observed.store(true, std::memory_order_relaxed);
+            return m_stamp;
+        }
+
+        /**
+        * @brief Moves the matrix to a new stamp, invalidating every cached property.
+        * Called by all mutators, call it after writing through a reference or row pointer that
+        * was obtained before the last property query. A stamp nobody has looked at yet is kept,
+        * so element loops only pay for a relaxed load.
+        */
+
+        template<class T>
+        void Matrix<T>::markModified()
+        {
+            if (m_cache.observed.load(std::memory_order_relaxed)) {
+                m_stamp = detail::nextStamp();
+                m_cache.observed.store(false, std::memory_order_relaxed);
+            }
+        }
+
         template<class T>
         std::vector<T> Matrix<T>::getDiagonal() const
         {
-            return this->m_diagonal;
+            return cached(m_cache.diagonal, [this]() {
+                std::vector<T> diagonal(std::min(m_rows, m_cols));
+                for (size_t i = 0; i < diagonal.size(); ++i) {
+                    diagonal[i] = m_elements[i][i];
+                }
+                return diagonal;
+            });
         }
 
+        template<class T>
+        bool Matrix<T>::isSymmetric() const
+        {
+            return cached(m_cache.symmetric, [this]() {
+                if (m_rows != m_cols) {
+                    return false;
+                }
+                for (size_t i = 0; i < m_rows; ++i) {
+                    for (size_t j = 0; j < i; ++j) {
+                        if (!(m_elements[i][j] == m_elements[j][i])) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            });
+        }
+
+        /**
+        * @brief True if every element above the main diagonal is zero.
+        */
+
+        template<class T>
+        bool Matrix<T>::isLowerTriangular() const
+        {
+            return cached(m_cache.lower, [this]() {
+                for (size_t i = 0; i < m_rows; ++i) {
+                    for (size_t j = i + 1; j < m_cols; ++j) {
+                        if (!(m_elements[i][j] == static_cast<T>(0))) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            });
+        }
+
+        /**
+        * @brief True if every element below the main diagonal is zero.
+        */
+
+        template<class T>
+        bool Matrix<T>::isUpperTriangular() const
+        {
+            return cached(m_cache.upper, [this]() {
+                for (size_t i = 0; i < m_rows; ++i) {
+                    for (size_t j = 0; j < std::min(i, m_cols); ++j) {
+                        if (!(m_elements[i][j] == static_cast<T>(0))) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            });
+        }
+
+        template<class T>
+        bool Matrix<T>::isDiagonal() const
+        {
+            return isLowerTriangular() && isUpperTriangular();
+        }
+
+        /**
+        * @brief Transposes in square tiles of TuningParameters::transposeTile, so the rows read and
+        * the rows written both stay in cache. Rows of the result are split over threads.
+        */
+
         template<class T>
         void Matrix<T>::transpose() 
         {
-            Matrix<T> newMatrix(this->getCols(), this->getRows());
+            std::vector<std::vector<T>> transposed(m_cols);
+            const size_t tile = detail::currentTuning().transposeTile;
 
-            for (size_t i = 0; i < this->getRows(); ++i) {
-                for (size_t j = 0; j < this->getCols(); ++j) {
-                    newMatrix.setElement(j, i, this->m_elements[i][j]);
+            detail::parallelFor(0, m_cols, tile, [&](size_t lo, size_t hi) {
+                for (size_t j = lo; j < hi; ++j) {
+                    transposed[j].resize(m_rows);
                 }
-            }
-            (*this) = newMatrix;
+                for (size_t jj = lo; jj < hi; jj += tile) {
+                    const size_t jEnd = std::min(jj + tile, hi);
+                    for (size_t ii = 0; ii < m_rows; ii += tile) {
+                        const size_t iEnd = std::min(ii + tile, m_rows);
+                        for (size_t j = jj; j < jEnd; ++j) {
+                            T* out = transposed[j].data();
+                            for (size_t i = ii; i < iEnd; ++i) {
+                                out[i] = m_elements[i][j];
+                            }
+                        }
+                    }
+                }
+            });
+            markModified();
+            m_elements.swap(transposed);
+            std::swap(m_rows, m_cols);
         }
 
 
@@ -673,11 +1144,10 @@ namespace NumeriCore
         template<class U>
         Matrix<U> operator*(const U& scalar, const Matrix<U>& mat) 
         {
-            Matrix<U> result (mat.getCols(), mat.getRows());
+            Matrix<U> result = mat;
             for (size_t i = 0; i < mat.getRows(); ++i) {
                 for (size_t j = 0; j < mat.getCols(); ++j) {
                     result.setElement(i, j, mat.getElement(i, j) * scalar);
-                    std::cout <<"I : " << i << "\tJ : "<< j << "\tresult : "<< result.getElement(i, j) << "\n";
                 }
             }
             return result;
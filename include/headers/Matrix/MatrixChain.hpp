@@ -0,0 +1,416 @@
+#ifndef __MATRIXCHAIN_HPP__
+#define __MATRIXCHAIN_HPP__
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief One multiplication of a chain plan.
+         * Computes the product of operands [first, last] as the product of [first, split] and
+         * [split + 1, last]. Operands and the result live in workspace buffers, a single input
+         * matrix is packed into its buffer right before the step that reads it.
+         */
+        struct ChainStep
+        {
+            size_t first = 0;
+            size_t split = 0;
+            size_t last = 0;
+            size_t rows = 0;        // rows of the result
+            size_t inner = 0;       // shared dimension
+            size_t cols = 0;        // cols of the result
+            size_t leftBuffer = 0;  // buffer holding [first, split]
+            size_t rightBuffer = 0; // buffer holding [split + 1, last]
+            size_t resultBuffer = 0;
+        };
+
+
+        /**
+         * @brief Evaluation order chosen for a matrix chain and what it costs.
+         * Multiply-add counts are rows * inner * cols summed over the steps.
+         */
+        struct ChainPlan
+        {
+            std::vector<ChainStep> steps;         // in execution order
+            std::string order;                    // parenthesization, operands named A0, A1, ...
+            size_t multiplyAdds = 0;              // cost of this plan
+            size_t leftToRightMultiplyAdds = 0;   // cost of ((A0 * A1) * A2) * ...
+            std::vector<size_t> bufferSizes;      // elements of each reusable workspace buffer
+            size_t workspaceBytes = 0;            // all workspace buffers together
+        };
+
+
+        namespace detail
+        {
+            /**
+            * @brief Hands out workspace buffers, preferring the smallest free one that is large
+            * enough and otherwise growing the largest free one. Only sizes are tracked, the plan
+            * replays the same sequence on real storage.
+            */
+            class ChainBufferPool
+            {
+            public:
+                size_t acquire(size_t elements)
+                {
+                    size_t best = m_sizes.size();
+                    for (size_t b = 0; b < m_sizes.size(); ++b) {
+                        if (!m_free[b]) {
+                            continue;
+                        }
+                        if (best == m_sizes.size()) {
+                            best = b;
+                            continue;
+                        }
+                        const bool fits = m_sizes[b] >= elements;
+                        const bool bestFits = m_sizes[best] >= elements;
+                        if ((fits && (!bestFits || m_sizes[b] < m_sizes[best])) || (!fits && !bestFits && m_sizes[b] > m_sizes[best])) {
+                            best = b;
+                        }
+                    }
+                    if (best == m_sizes.size()) {
+                        m_sizes.push_back(0);
+                        m_free.push_back(true);
+                    }
+                    m_sizes[best] = std::max(m_sizes[best], elements);
+                    m_free[best] = false;
+                    return best;
+                }
+
+                void release(size_t buffer)
+                {
+                    m_free[buffer] = true;
+                }
+
+                const std::vector<size_t>& getSizes() const
+                {
+                    return m_sizes;
+                }
+
+            private:
+                std::vector<size_t> m_sizes;
+                std::vector<bool> m_free;
+            };
+
+
+            /**
+            * @brief Appends the steps of sub-chain [i, j] in post order and returns the buffer that
+            * holds its result. Single operands are packed only after both sub-chains are done, so
+            * besides results still waiting for use only the current step's buffers are live.
+            */
+            inline size_t planChain(const std::vector<size_t>& dims, const std::vector<std::vector<size_t>>& split,
+                                    size_t i, size_t j, ChainBufferPool& pool, ChainPlan& plan)
+            {
+                const size_t k = split[i][j];
+                size_t left = k == i ? 0 : planChain(dims, split, i, k, pool, plan);
+                size_t right = k + 1 == j ? 0 : planChain(dims, split, k + 1, j, pool, plan);
+                if (k == i) {
+                    left = pool.acquire(dims[i] * dims[i + 1]);
+                }
+                if (k + 1 == j) {
+                    right = pool.acquire(dims[j] * dims[j + 1]);
+                }
+
+                ChainStep step;
+                step.first = i;
+                step.split = k;
+                step.last = j;
+                step.rows = dims[i];
+                step.inner = dims[k + 1];
+                step.cols = dims[j + 1];
+                step.leftBuffer = left;
+                step.rightBuffer = right;
+                step.resultBuffer = pool.acquire(step.rows * step.cols);
+                pool.release(left);
+                pool.release(right);
+                plan.steps.push_back(step);
+                return step.resultBuffer;
+            }
+
+            inline std::string chainOrder(const std::vector<std::vector<size_t>>& split, size_t i, size_t j)
+            {
+                if (i == j) {
+                    return "A" + std::to_string(i);
+                }
+                return "(" + chainOrder(split, i, split[i][j]) + " * " + chainOrder(split, split[i][j] + 1, j) + ")";
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Chooses the cheapest parenthesization of a product chain.
+        * Classic O(n^3) dynamic programming over the shapes: cost(i, j) is the minimum over k of
+        * cost(i, k) + cost(k + 1, j) + d_i * d_(k+1) * d_(j+1).
+        *
+        * @param dims Operand i is dims[i] x dims[i + 1], so n operands need n + 1 entries.
+        * @param elementSize Bytes per element, used for workspaceBytes.
+        * @throw std::invalid_argument If fewer than two entries are given.
+        */
+
+        inline ChainPlan planMatrixChain(const std::vector<size_t>& dims, size_t elementSize)
+        {
+            if (dims.size() < 2) {
+                throw std::invalid_argument("A matrix chain needs at least one operand!");
+            }
+            const size_t n = dims.size() - 1;
+            std::vector<std::vector<size_t>> cost(n, std::vector<size_t>(n, 0));
+            std::vector<std::vector<size_t>> split(n, std::vector<size_t>(n, 0));
+            for (size_t length = 2; length <= n; ++length) {
+                for (size_t i = 0; i + length <= n; ++i) {
+                    const size_t j = i + length - 1;
+                    cost[i][j] = std::numeric_limits<size_t>::max();
+                    for (size_t k = i; k < j; ++k) {
+                        const size_t c = cost[i][k] + cost[k + 1][j] + dims[i] * dims[k + 1] * dims[j + 1];
+                        if (c < cost[i][j]) {
+                            cost[i][j] = c;
+                            split[i][j] = k;
+                        }
+                    }
+                }
+            }
+
+            ChainPlan plan;
+            plan.order = detail::chainOrder(split, 0, n - 1);
+            plan.multiplyAdds = cost[0][n - 1];
+            for (size_t k = 1; k < n; ++k) {
+                plan.leftToRightMultiplyAdds += dims[0] * dims[k] * dims[k + 1];
+            }
+            if (n > 1) {
+                detail::ChainBufferPool pool;
+                detail::planChain(dims, split, 0, n - 1, pool, plan);
+                plan.bufferSizes = pool.getSizes();
+                for (size_t size : plan.bufferSizes) {
+                    plan.workspaceBytes += size * elementSize;
+                }
+            }
+            return plan;
+        }
+
+
+        /**
+         * @brief Lazy product of several matrices.
+         * Operands are only collected, the product is formed on evaluate() (or conversion to
+         * Matrix) in the order with the fewest multiply-adds. The chain keeps references, the
+         * operands must outlive it.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::Matrix<double> r = NumeriCore::Matrix::chain(a, b, c, d);
+         * std::cout << NumeriCore::Matrix::chain(a) * b * c * d;  // prints the plan
+         * \endcode
+         */
+        template<class T>
+        class MatrixChain
+        {
+        public:
+            MatrixChain() = default;
+            explicit MatrixChain(const Matrix<T>& first);
+
+            ~MatrixChain() = default;
+
+        public:
+            MatrixChain& operator *=(const Matrix<T>& m); // append an operand
+
+            ChainPlan plan() const; // evaluation order and cost
+            Matrix<T> evaluate() const; // run the plan
+            operator Matrix<T>() const; // same as evaluate()
+
+            size_t getLength() const; // number of operands
+            size_t getRows() const; // rows of the product
+            size_t getCols() const; // cols of the product
+
+        private:
+            std::vector<size_t> dims() const;
+
+        private:
+            std::vector<const Matrix<T>*> m_operands;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // MatrixChain class c-tors and operators
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        MatrixChain<T>::MatrixChain(const Matrix<T>& first)
+            : m_operands{ &first }
+        {
+        }
+
+        /**
+        * @brief Appends an operand to the chain.
+        * @throw std::invalid_argument If its rows do not match the columns of the chain.
+        */
+
+        template<class T>
+        MatrixChain<T>& MatrixChain<T>::operator *=(const Matrix<T>& m)
+        {
+            if (!m_operands.empty() && m_operands.back()->getCols() != m.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            m_operands.push_back(&m);
+            return *this;
+        }
+
+        template<class T>
+        MatrixChain<T> operator*(MatrixChain<T> chain, const Matrix<T>& m)
+        {
+            chain *= m;
+            return chain;
+        }
+
+        /**
+        * @brief Starts a chain from one or more matrices.
+        * @throw std::invalid_argument If neighbouring shapes do not match.
+        */
+
+        template<class T, class... Rest>
+        MatrixChain<T> chain(const Matrix<T>& first, const Rest&... rest)
+        {
+            MatrixChain<T> result(first);
+            (result *= ... *= rest);
+            return result;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // MatrixChain class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        std::vector<size_t> MatrixChain<T>::dims() const
+        {
+            std::vector<size_t> result;
+            result.reserve(m_operands.size() + 1);
+            for (const Matrix<T>* m : m_operands) {
+                result.push_back(m->getRows());
+            }
+            if (!m_operands.empty()) {
+                result.push_back(m_operands.back()->getCols());
+            }
+            return result;
+        }
+
+        /**
+        * @throw std::invalid_argument If the chain is empty.
+        */
+
+        template<class T>
+        ChainPlan MatrixChain<T>::plan() const
+        {
+            return planMatrixChain(dims(), sizeof(T));
+        }
+
+        /**
+        * @brief Forms the product following plan().
+        * Every step is one blocked GEMM whose row bands run in parallel. Intermediate results and
+        * packed inputs share the plan's workspace buffers, so a buffer freed by one step is
+        * reused by the next.
+        *
+        * @throw std::invalid_argument If the chain is empty.
+        */
+
+        template<class T>
+        Matrix<T> MatrixChain<T>::evaluate() const
+        {
+            const ChainPlan chainPlan = plan();
+            if (m_operands.size() == 1) {
+                return *m_operands.front();
+            }
+
+            std::vector<std::vector<T>> buffers(chainPlan.bufferSizes.size());
+            for (size_t b = 0; b < buffers.size(); ++b) {
+                buffers[b].resize(chainPlan.bufferSizes[b]);
+            }
+            auto load = [&](size_t operand, size_t buffer) {
+                const Matrix<T>& m = *m_operands[operand];
+                T* out = buffers[buffer].data();
+                for (size_t i = 0; i < m.getRows(); ++i) {
+                    std::copy(m.rowData(i), m.rowData(i) + m.getCols(), out + i * m.getCols());
+                }
+            };
+
+            for (const ChainStep& step : chainPlan.steps) {
+                if (step.first == step.split) {
+                    load(step.first, step.leftBuffer);
+                }
+                if (step.split + 1 == step.last) {
+                    load(step.last, step.rightBuffer);
+                }
+                const T* a = buffers[step.leftBuffer].data();
+                const T* b = buffers[step.rightBuffer].data();
+                T* c = buffers[step.resultBuffer].data();
+                detail::parallelFor(0, step.rows, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                    detail::gemm(hi - lo, step.cols, step.inner, a + lo * step.inner, step.inner, b, step.cols, c + lo * step.cols, step.cols);
+                });
+            }
+
+            const ChainStep& last = chainPlan.steps.back();
+            Matrix<T> result(last.rows, last.cols, zeroFill);
+            detail::unpack(buffers[last.resultBuffer].data(), last.cols, result);
+            return result;
+        }
+
+        template<class T>
+        MatrixChain<T>::operator Matrix<T>() const
+        {
+            return evaluate();
+        }
+
+        template<class T>
+        size_t MatrixChain<T>::getLength() const
+        {
+            return m_operands.size();
+        }
+
+        template<class T>
+        size_t MatrixChain<T>::getRows() const
+        {
+            return m_operands.empty() ? 0 : m_operands.front()->getRows();
+        }
+
+        template<class T>
+        size_t MatrixChain<T>::getCols() const
+        {
+            return m_operands.empty() ? 0 : m_operands.back()->getCols();
+        }
+
+
+        /**
+        * @brief Prints the parenthesization, the cost against left-to-right evaluation, the
+        * workspace and every step.
+        */
+
+        inline std::ostream& operator<<(std::ostream& os, const ChainPlan& plan)
+        {
+            os << plan.order << "\n"
+               << "multiply-adds: " << plan.multiplyAdds << " (left to right: " << plan.leftToRightMultiplyAdds << ")\n"
+               << "workspace: " << plan.bufferSizes.size() << " buffers, " << plan.workspaceBytes << " bytes\n";
+            for (const ChainStep& step : plan.steps) {
+                os << "  [" << step.first << ".." << step.split << "] * [" << (step.split + 1) << ".." << step.last << "]  "
+                   << step.rows << "x" << step.inner << " * " << step.inner << "x" << step.cols
+                   << "  buffers " << step.leftBuffer << ", " << step.rightBuffer << " -> " << step.resultBuffer << "\n";
+            }
+            return os;
+        }
+
+        template<class T>
+        std::ostream& operator<<(std::ostream& os, const MatrixChain<T>& chain)
+        {
+            return os << chain.plan();
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __MATRIXCHAIN_HPP__ */
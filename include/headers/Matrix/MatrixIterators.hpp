@@ -0,0 +1,318 @@
+#ifndef __MATRIXITERATORS_HPP__
+#define __MATRIXITERATORS_HPP__
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Element access policies
+        //
+        // getElement(), setElement(), operator() and row() check bounds in debug builds and not in
+        // release builds (NDEBUG). Define NUMERICORE_CHECKED_ACCESS or NUMERICORE_UNCHECKED_ACCESS
+        // to force either. at() always checks, the iterators never do.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        struct CheckedAccess
+        {
+            template<class Rows>
+            static auto& get(Rows& rows, size_t row, size_t col)
+            {
+                return rows.at(row).at(col);
+            }
+        };
+
+        struct UncheckedAccess
+        {
+            template<class Rows>
+            static auto& get(Rows& rows, size_t row, size_t col)
+            {
+                return rows[row][col];
+            }
+        };
+
+#if defined(NUMERICORE_CHECKED_ACCESS) || (!defined(NUMERICORE_UNCHECKED_ACCESS) && !defined(NDEBUG))
+        using DefaultAccess = CheckedAccess;
+#else
+        using DefaultAccess = UncheckedAccess;
+#endif
+
+
+        namespace detail
+        {
+            // Row storage seen through an element type, const elements give const rows.
+            template<class E>
+            using RowStorage = std::conditional_t<std::is_const_v<E>, const std::vector<std::remove_const_t<E>>, std::vector<E>>;
+
+
+            /**
+            * @brief Random-access iterator over all elements in row-major order.
+            * Rows are separate allocations, so the iterator keeps a (row, column) position and
+            * only divides when it jumps.
+            */
+            template<class E>
+            class ElementIterator
+            {
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = std::remove_const_t<E>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = E*;
+                using reference = E&;
+
+                ElementIterator() = default;
+                ElementIterator(RowStorage<E>* rows, size_t cols, size_t index)
+                    : m_rows(rows), m_cols(cols), m_row(cols ? index / cols : 0), m_col(cols ? index % cols : 0) {}
+
+                template<class Other, class = std::enable_if_t<std::is_same_v<const Other, E> && !std::is_same_v<Other, E>>>
+                ElementIterator(const ElementIterator<Other>& other)
+                    : m_rows(other.m_rows), m_cols(other.m_cols), m_row(other.m_row), m_col(other.m_col) {}
+
+                reference operator*() const { return m_rows[m_row][m_col]; }
+                pointer operator->() const { return &m_rows[m_row][m_col]; }
+                reference operator[](difference_type n) const { return *(*this + n); }
+
+                ElementIterator& operator++()
+                {
+                    if (++m_col == m_cols) {
+                        ++m_row;
+                        m_col = 0;
+                    }
+                    return *this;
+                }
+                ElementIterator& operator--()
+                {
+                    if (m_col == 0) {
+                        --m_row;
+                        m_col = m_cols;
+                    }
+                    --m_col;
+                    return *this;
+                }
+                ElementIterator operator++(int) { ElementIterator old = *this; ++*this; return old; }
+                ElementIterator operator--(int) { ElementIterator old = *this; --*this; return old; }
+
+                ElementIterator& operator+=(difference_type n)
+                {
+                    const size_t index = static_cast<size_t>(static_cast<difference_type>(position()) + n);
+                    m_row = m_cols ? index / m_cols : 0;
+                    m_col = m_cols ? index % m_cols : 0;
+                    return *this;
+                }
+                ElementIterator& operator-=(difference_type n) { return *this += -n; }
+                friend ElementIterator operator+(ElementIterator it, difference_type n) { return it += n; }
+                friend ElementIterator operator+(difference_type n, ElementIterator it) { return it += n; }
+                friend ElementIterator operator-(ElementIterator it, difference_type n) { return it -= n; }
+                friend difference_type operator-(const ElementIterator& a, const ElementIterator& b)
+                {
+                    return static_cast<difference_type>(a.position()) - static_cast<difference_type>(b.position());
+                }
+
+                friend bool operator==(const ElementIterator& a, const ElementIterator& b) { return a.position() == b.position(); }
+                friend bool operator!=(const ElementIterator& a, const ElementIterator& b) { return !(a == b); }
+                friend bool operator<(const ElementIterator& a, const ElementIterator& b) { return a.position() < b.position(); }
+                friend bool operator>(const ElementIterator& a, const ElementIterator& b) { return b < a; }
+                friend bool operator<=(const ElementIterator& a, const ElementIterator& b) { return !(b < a); }
+                friend bool operator>=(const ElementIterator& a, const ElementIterator& b) { return !(a < b); }
+
+                size_t getRow() const { return m_row; }
+                size_t getCol() const { return m_col; }
+
+            private:
+                template<class> friend class ElementIterator;
+
+                size_t position() const { return m_row * m_cols + m_col; }
+
+            private:
+                RowStorage<E>* m_rows = nullptr;
+                size_t m_cols = 0;
+                size_t m_row = 0;
+                size_t m_col = 0;
+            };
+
+
+            /**
+            * @brief Random-access iterator down one column.
+            */
+            template<class E>
+            class ColumnIterator
+            {
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = std::remove_const_t<E>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = E*;
+                using reference = E&;
+
+                ColumnIterator() = default;
+                ColumnIterator(RowStorage<E>* rows, size_t col, size_t row) : m_rows(rows), m_col(col), m_row(row) {}
+
+                reference operator*() const { return m_rows[m_row][m_col]; }
+                pointer operator->() const { return &m_rows[m_row][m_col]; }
+                reference operator[](difference_type n) const { return m_rows[m_row + n][m_col]; }
+
+                ColumnIterator& operator++() { ++m_row; return *this; }
+                ColumnIterator& operator--() { --m_row; return *this; }
+                ColumnIterator operator++(int) { ColumnIterator old = *this; ++m_row; return old; }
+                ColumnIterator operator--(int) { ColumnIterator old = *this; --m_row; return old; }
+                ColumnIterator& operator+=(difference_type n) { m_row += n; return *this; }
+                ColumnIterator& operator-=(difference_type n) { m_row -= n; return *this; }
+                friend ColumnIterator operator+(ColumnIterator it, difference_type n) { return it += n; }
+                friend ColumnIterator operator+(difference_type n, ColumnIterator it) { return it += n; }
+                friend ColumnIterator operator-(ColumnIterator it, difference_type n) { return it -= n; }
+                friend difference_type operator-(const ColumnIterator& a, const ColumnIterator& b)
+                {
+                    return static_cast<difference_type>(a.m_row) - static_cast<difference_type>(b.m_row);
+                }
+
+                friend bool operator==(const ColumnIterator& a, const ColumnIterator& b) { return a.m_row == b.m_row; }
+                friend bool operator!=(const ColumnIterator& a, const ColumnIterator& b) { return a.m_row != b.m_row; }
+                friend bool operator<(const ColumnIterator& a, const ColumnIterator& b) { return a.m_row < b.m_row; }
+                friend bool operator>(const ColumnIterator& a, const ColumnIterator& b) { return b.m_row < a.m_row; }
+                friend bool operator<=(const ColumnIterator& a, const ColumnIterator& b) { return a.m_row <= b.m_row; }
+                friend bool operator>=(const ColumnIterator& a, const ColumnIterator& b) { return a.m_row >= b.m_row; }
+
+            private:
+                RowStorage<E>* m_rows = nullptr;
+                size_t m_col = 0;
+                size_t m_row = 0;
+            };
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief One row, a contiguous run of elements iterated by plain pointers.
+        */
+        template<class E>
+        class RowView
+        {
+        public:
+            using iterator = E*;
+
+            RowView(E* data, size_t size) : m_data(data), m_size(size) {}
+
+            E* begin() const { return m_data; }
+            E* end() const { return m_data + m_size; }
+            E* data() const { return m_data; }
+            size_t size() const { return m_size; }
+            E& operator[](size_t col) const { return m_data[col]; }
+
+        private:
+            E* m_data;
+            size_t m_size;
+        };
+
+        /**
+        * @brief One column, iterated by a strided random-access iterator.
+        */
+        template<class E>
+        class ColumnView
+        {
+        public:
+            using iterator = detail::ColumnIterator<E>;
+
+            ColumnView(detail::RowStorage<E>* rows, size_t col, size_t size) : m_rows(rows), m_col(col), m_size(size) {}
+
+            iterator begin() const { return iterator(m_rows, m_col, 0); }
+            iterator end() const { return iterator(m_rows, m_col, m_size); }
+            size_t size() const { return m_size; }
+            E& operator[](size_t row) const { return m_rows[row][m_col]; }
+
+        private:
+            detail::RowStorage<E>* m_rows;
+            size_t m_col;
+            size_t m_size;
+        };
+
+
+        namespace detail
+        {
+            /**
+            * @brief Random-access iterator whose elements are row or column views.
+            * Dereferencing builds the view by value, like std::vector<bool> this is a proxy
+            * reference. It is accepted by the standard and parallel algorithms.
+            */
+            template<class E, bool Rows>
+            class ViewIterator
+            {
+            public:
+                using View = std::conditional_t<Rows, RowView<E>, ColumnView<E>>;
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = View;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = View;
+
+                ViewIterator() = default;
+                ViewIterator(RowStorage<E>* rows, size_t length, size_t index) : m_rows(rows), m_length(length), m_index(index) {}
+
+                View operator*() const
+                {
+                    if constexpr (Rows) {
+                        return View(m_rows[m_index].data(), m_length);
+                    }
+                    else {
+                        return View(m_rows, m_index, m_length);
+                    }
+                }
+                View operator[](difference_type n) const { return *(*this + n); }
+
+                ViewIterator& operator++() { ++m_index; return *this; }
+                ViewIterator& operator--() { --m_index; return *this; }
+                ViewIterator operator++(int) { ViewIterator old = *this; ++m_index; return old; }
+                ViewIterator operator--(int) { ViewIterator old = *this; --m_index; return old; }
+                ViewIterator& operator+=(difference_type n) { m_index += n; return *this; }
+                ViewIterator& operator-=(difference_type n) { m_index -= n; return *this; }
+                friend ViewIterator operator+(ViewIterator it, difference_type n) { return it += n; }
+                friend ViewIterator operator+(difference_type n, ViewIterator it) { return it += n; }
+                friend ViewIterator operator-(ViewIterator it, difference_type n) { return it -= n; }
+                friend difference_type operator-(const ViewIterator& a, const ViewIterator& b)
+                {
+                    return static_cast<difference_type>(a.m_index) - static_cast<difference_type>(b.m_index);
+                }
+
+                friend bool operator==(const ViewIterator& a, const ViewIterator& b) { return a.m_index == b.m_index; }
+                friend bool operator!=(const ViewIterator& a, const ViewIterator& b) { return a.m_index != b.m_index; }
+                friend bool operator<(const ViewIterator& a, const ViewIterator& b) { return a.m_index < b.m_index; }
+                friend bool operator>(const ViewIterator& a, const ViewIterator& b) { return b.m_index < a.m_index; }
+                friend bool operator<=(const ViewIterator& a, const ViewIterator& b) { return a.m_index <= b.m_index; }
+                friend bool operator>=(const ViewIterator& a, const ViewIterator& b) { return a.m_index >= b.m_index; }
+
+            private:
+                RowStorage<E>* m_rows = nullptr;
+                size_t m_length = 0; // elements per view
+                size_t m_index = 0;
+            };
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Pair of iterators usable in range-for and with the standard algorithms.
+        */
+        template<class It>
+        class IteratorRange
+        {
+        public:
+            IteratorRange(It first, It last) : m_first(first), m_last(last) {}
+
+            It begin() const { return m_first; }
+            It end() const { return m_last; }
+            size_t size() const { return static_cast<size_t>(m_last - m_first); }
+
+        private:
+            It m_first;
+            It m_last;
+        };
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __MATRIXITERATORS_HPP__ */
@@ -0,0 +1,223 @@
+#ifndef __NUMA_HPP__
+#define __NUMA_HPP__
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "Matrix.hpp"
+#include "Parallel.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Placement policy for the pages of a matrix.
+         * Partitioned binds every row block to the node of the core that processes it in row
+         * parallel kernels, Interleave spreads the pages round robin over all nodes and Bind
+         * puts every page on a single node.
+         */
+        enum class NumaPolicy
+        {
+            Partitioned,
+            Interleave,
+            Bind
+        };
+
+
+        /**
+         * @brief NUMA nodes of the machine and the logical CPUs belonging to each.
+         * Machines without NUMA information are reported as a single node holding every CPU.
+         */
+        struct NumaTopology
+        {
+            std::vector<std::vector<size_t>> nodeCpus; // logical CPUs of each node
+            std::vector<size_t> cpuNode; // node of each logical CPU
+
+            size_t getNodeCount() const { return nodeCpus.size(); }
+            size_t nodeOfCpu(size_t cpu) const { return cpuNode.empty() ? 0 : cpuNode[cpu % cpuNode.size()]; }
+        };
+
+
+        namespace detail
+        {
+            // Parses a kernel cpu list such as "0-3,8-11".
+            inline std::vector<size_t> parseCpuList(const std::string& text)
+            {
+                std::vector<size_t> cpus;
+                std::stringstream stream(text);
+                std::string range;
+                while (std::getline(stream, range, ',')) {
+                    if (range.empty() || range == "\n") {
+                        continue;
+                    }
+                    const size_t dash = range.find('-');
+                    try {
+                        const size_t first = std::stoul(range.substr(0, dash));
+                        const size_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+                        for (size_t cpu = first; cpu <= last; ++cpu) {
+                            cpus.push_back(cpu);
+                        }
+                    }
+                    catch (const std::exception&) {
+                        return {};
+                    }
+                }
+                return cpus;
+            }
+
+            inline NumaTopology detectTopology()
+            {
+                NumaTopology topology;
+                const size_t cpus = hardwareThreads();
+                topology.cpuNode.assign(cpus, 0);
+#ifdef __linux__
+                for (size_t node = 0; ; ++node) {
+                    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    if (!file) {
+                        break;
+                    }
+                    std::string text;
+                    std::getline(file, text);
+                    topology.nodeCpus.push_back(parseCpuList(text));
+                    for (size_t cpu : topology.nodeCpus.back()) {
+                        if (cpu < cpus) {
+                            topology.cpuNode[cpu] = node;
+                        }
+                    }
+                }
+#endif
+                if (topology.nodeCpus.empty()) {
+                    topology.nodeCpus.emplace_back(cpus);
+                    for (size_t cpu = 0; cpu < cpus; ++cpu) {
+                        topology.nodeCpus[0][cpu] = cpu;
+                    }
+                }
+                return topology;
+            }
+
+
+            /**
+            * @brief Applies a memory policy to the whole pages inside [data, data + bytes) and
+            * migrates pages already touched. Goes straight to the mbind system call, so no libnuma
+            * is needed. Partial pages at both ends are left alone.
+            *
+            * @param interleave Interleave over every node instead of binding to node.
+            * @return false if the platform has no mbind or the kernel rejected the call.
+            */
+
+            inline bool bindPages(const void* data, size_t bytes, bool interleave, size_t node, size_t nodeCount)
+            {
+#if defined(__linux__) && defined(SYS_mbind)
+                constexpr int kBind = 2;             // MPOL_BIND
+                constexpr int kInterleave = 3;       // MPOL_INTERLEAVE
+                constexpr unsigned kMoveFlag = 1u << 1; // MPOL_MF_MOVE
+                constexpr size_t kMaskBits = 8 * sizeof(unsigned long);
+
+                const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+                const uintptr_t first = (reinterpret_cast<uintptr_t>(data) + page - 1) / page * page;
+                const uintptr_t last = (reinterpret_cast<uintptr_t>(data) + bytes) / page * page;
+                if (last <= first) {
+                    return true;
+                }
+
+                std::vector<unsigned long> mask((std::max(nodeCount, node + 1) + kMaskBits - 1) / kMaskBits, 0);
+                if (interleave) {
+                    for (size_t n = 0; n < nodeCount; ++n) {
+                        mask[n / kMaskBits] |= 1ul << (n % kMaskBits);
+                    }
+                }
+                else {
+                    mask[node / kMaskBits] |= 1ul << (node % kMaskBits);
+                }
+                return syscall(SYS_mbind, reinterpret_cast<void*>(first), last - first, interleave ? kInterleave : kBind,
+                    mask.data(), mask.size() * kMaskBits + 1, kMoveFlag) == 0;
+#else
+                (void)data; (void)bytes; (void)interleave; (void)node; (void)nodeCount;
+                return false;
+#endif
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Returns the NUMA topology, read once from /sys/devices/system/node.
+        */
+
+        inline const NumaTopology& numaTopology()
+        {
+            static const NumaTopology topology = detail::detectTopology();
+            return topology;
+        }
+
+
+        /**
+        * @brief Applies a placement policy to a memory range.
+        * Partitioned has no meaning for a plain range and binds to node like Bind.
+        *
+        * @return false if placement is unsupported here or was rejected by the kernel.
+        */
+
+        inline bool bindMemory(const void* data, size_t bytes, NumaPolicy policy, size_t node = 0)
+        {
+            const size_t nodes = numaTopology().getNodeCount();
+            return detail::bindPages(data, bytes, policy == NumaPolicy::Interleave, node % nodes, nodes);
+        }
+
+
+        /**
+        * @brief Moves the pages of an existing matrix according to a placement policy.
+        * Matrices built by the random constructor are already placed by first touch, this is
+        * for matrices filled serially or loaded from elsewhere. With Partitioned the rows are
+        * split like the constructors first touch them (detail::placementGrainRows) and chunk c is
+        * bound to the node of logical CPU c, which matches the placement seen by the row-band
+        * kernels running with thread pinning.
+        * Each row is a separate allocation, rows shorter than a page cannot be moved.
+        *
+        * Example usage:
+        * \code
+        * NumeriCore::Matrix::setThreadPinning(true);
+        * NumeriCore::Matrix::placeMatrix(a, NumeriCore::Matrix::NumaPolicy::Partitioned);
+        * \endcode
+        *
+        * @param m The matrix to place.
+        * @param policy The placement policy.
+        * @param node Target node for Bind.
+        * @return false if any row could not be placed.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        bool placeMatrix(Matrix<T>& m, NumaPolicy policy, size_t node = 0)
+        {
+            const size_t rows = m.getRows();
+            const size_t cols = m.getCols();
+            if (rows == 0 || cols == 0) {
+                return true;
+            }
+            const NumaTopology& topology = numaTopology();
+            const size_t chunks = detail::chunkCount(rows, detail::placementGrainRows(rows, cols));
+            const size_t chunk = (rows + chunks - 1) / chunks;
+
+            bool placed = true;
+            for (size_t r = 0; r < rows; ++r) {
+                const size_t target = policy == NumaPolicy::Partitioned ? topology.nodeOfCpu(r / chunk) : node;
+                placed = bindMemory(&m.getElement(r, 0), cols * sizeof(T), policy, target) && placed;
+            }
+            return placed;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __NUMA_HPP__ */
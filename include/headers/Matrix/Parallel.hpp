@@ -0,0 +1,222 @@
+#ifndef __PARALLEL_HPP__
+#define __PARALLEL_HPP__
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <optional>
+
+#include "Tuning.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        namespace detail
+        {
+            constexpr size_t kParallelGrainRows = 64; // minimum rows per chunk of row-parallel loops
+
+            inline std::atomic<bool>& threadPinningFlag()
+            {
+                static std::atomic<bool> flag{ false };
+                return flag;
+            }
+
+            inline size_t hardwareThreads()
+            {
+                return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            }
+
+
+            /**
+            * @brief Number of chunks parallelFor() splits count indices into.
+            * Chunk c covers [c * size, (c + 1) * size) with size = ceil(count / chunks). Every row
+            * parallel loop uses this partition, so a matrix initialized by parallelFor() is touched
+            * by the same threads, and with pinning the same cores, that process it later.
+            */
+
+            inline size_t chunkCount(size_t count, size_t grain)
+            {
+                const size_t g = std::max<size_t>(grain, 1);
+                return std::max<size_t>(std::min(hardwareThreads(), (count + g - 1) / g), 1);
+            }
+
+
+            /**
+            * @brief Pins the calling thread to one logical CPU, taken modulo the number of CPUs.
+            * @return false if pinning is unsupported on this platform or was rejected.
+            */
+
+            inline bool pinCurrentThread(size_t cpu)
+            {
+#ifdef __linux__
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu % std::min<size_t>(hardwareThreads(), CPU_SETSIZE), &set);
+                return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+                (void)cpu;
+                return false;
+#endif
+            }
+
+
+            /**
+            * @brief Pins the calling thread for the lifetime of the guard and restores its previous
+            * affinity afterwards.
+            */
+
+            class AffinityGuard
+            {
+            public:
+                explicit AffinityGuard(size_t cpu)
+                {
+#ifdef __linux__
+                    m_saved = pthread_getaffinity_np(pthread_self(), sizeof(m_previous), &m_previous) == 0;
+                    if (m_saved) {
+                        pinCurrentThread(cpu);
+                    }
+#else
+                    (void)cpu;
+#endif
+                }
+
+                ~AffinityGuard()
+                {
+#ifdef __linux__
+                    if (m_saved) {
+                        pthread_setaffinity_np(pthread_self(), sizeof(m_previous), &m_previous);
+                    }
+#endif
+                }
+
+                AffinityGuard(const AffinityGuard&) = delete;
+                AffinityGuard& operator=(const AffinityGuard&) = delete;
+
+            private:
+#ifdef __linux__
+                cpu_set_t m_previous;
+                bool m_saved = false;
+#endif
+            };
+
+
+            /**
+            * @brief Grain in rows of an elementwise loop over rows of cols elements, so that every
+            * thread gets at least TuningParameters::elementwiseGrain elements.
+            */
+
+            inline size_t elementwiseGrainRows(size_t cols)
+            {
+                return std::max<size_t>(currentTuning().elementwiseGrain / std::max<size_t>(cols, 1), 1);
+            }
+
+            /**
+            * @brief Grain in rows of the row-band kernels (gemm, LU, Cholesky, ...), read from the
+            * current tuning.
+            */
+
+            inline size_t rowBandGrainRows()
+            {
+                return currentTuning().gemmGrainRows;
+            }
+
+            /**
+            * @brief Grain in rows with which a rows x cols matrix is first touched and placed.
+            * Matrices of at least TuningParameters::elementwiseGrain elements are split like the
+            * row-band kernels split them, so every row block is first touched, and placed by
+            * placeMatrix(), on the thread and node that later process it, also after retuning.
+            * Smaller matrices are filled by the calling thread alone.
+            */
+
+            inline size_t placementGrainRows(size_t rows, size_t cols)
+            {
+                if (rows * cols < currentTuning().elementwiseGrain) {
+                    return std::max<size_t>(rows, 1);
+                }
+                return rowBandGrainRows();
+            }
+
+
+            /**
+            * @brief Splits [begin, end) into chunkCount() contiguous chunks and runs
+            * f(chunkBegin, chunkEnd) on each. The calling thread takes the first chunk, exceptions
+            * thrown by any chunk are rethrown here. With thread pinning enabled chunk c runs on
+            * logical CPU c.
+            *
+            * @param begin First index.
+            * @param end One past the last index.
+            * @param grain Minimum number of indices per chunk, smaller ranges run serially.
+            * @param f Callable taking (size_t chunkBegin, size_t chunkEnd).
+            */
+
+            template<class F>
+            inline void parallelFor(size_t begin, size_t end, size_t grain, F&& f)
+            {
+                if (end <= begin) {
+                    return;
+                }
+                const size_t count = end - begin;
+                const size_t threads = chunkCount(count, grain);
+                const bool pin = threadPinningFlag().load(std::memory_order_relaxed);
+                if (threads <= 1) {
+                    f(begin, end);
+                    return;
+                }
+
+                const size_t chunk = (count + threads - 1) / threads;
+                std::vector<std::future<void>> pending;
+                pending.reserve(threads - 1);
+                size_t index = 1;
+                for (size_t lo = begin + chunk; lo < end; lo += chunk, ++index) {
+                    const size_t hi = std::min(lo + chunk, end);
+                    pending.push_back(std::async(std::launch::async, [&f, lo, hi, pin, index]() {
+                        if (pin) {
+                            pinCurrentThread(index);
+                        }
+                        f(lo, hi);
+                    }));
+                }
+                {
+                    std::optional<AffinityGuard> guard;
+                    if (pin) {
+                        guard.emplace(0);
+                    }
+                    f(begin, std::min(begin + chunk, end));
+                }
+                for (auto& task : pending) {
+                    task.get();
+                }
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Enables pinning of the threads of row-parallel kernels to fixed cores.
+        * Chunk c of every parallel loop, and worker c of pools created with pinning, runs on
+        * logical CPU c. Combined with first-touch initialization this keeps each row block on the
+        * NUMA node of the core that processes it.
+        */
+
+        inline void setThreadPinning(bool enabled)
+        {
+            detail::threadPinningFlag().store(enabled);
+        }
+
+        inline bool getThreadPinning()
+        {
+            return detail::threadPinningFlag().load();
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __PARALLEL_HPP__ */
@@ -0,0 +1,124 @@
+#ifndef __PROPERTYCACHE_HPP__
+#define __PROPERTYCACHE_HPP__
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <utility>
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        namespace detail
+        {
+            // Magnitude type of T, T itself for real types.
+            template<class T>
+            using Real = decltype(std::abs(std::declval<T>()));
+
+            /**
+            * @brief Returns a process-wide unique content stamp.
+            * A matrix takes a new stamp when it is created and on the first mutation after its
+            * stamp was observed, copies share the stamp. This is a best-effort invalidation
+            * contract, not a content identity: writes through a reference or row pointer taken
+            * before the stamp was observed do not move it, so such a matrix may keep its stamp
+            * while its contents change. Call markModified() after writing that way.
+            */
+
+            inline uint64_t nextStamp()
+            {
+                static std::atomic<uint64_t> counter{ 0 };
+                return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+            }
+
+            template<class V>
+            struct CacheSlot
+            {
+                uint64_t stamp = 0; // 0 never matches a live matrix
+                V value{};
+            };
+
+
+            /**
+            * @brief Lazily computed properties of a matrix, each tagged with the content stamp it
+            * was computed for. An entry is valid only while its stamp equals the matrix's, so
+            * invalidation is a single stamp change. The mutex lets concurrent const queries fill
+            * entries safely. The reduction based norms keep one entry per reduction mode.
+            */
+
+            template<class T>
+            struct PropertyCache
+            {
+                PropertyCache() = default;
+
+                PropertyCache(const PropertyCache& other)
+                {
+                    std::lock_guard<std::mutex> lock(other.mutex);
+                    assign(other);
+                }
+
+                PropertyCache(PropertyCache&& other) noexcept
+                {
+                    std::lock_guard<std::mutex> lock(other.mutex);
+                    assign(std::move(other));
+                }
+
+                PropertyCache& operator =(const PropertyCache& other)
+                {
+                    if (this != &other) {
+                        std::scoped_lock lock(mutex, other.mutex);
+                        assign(other);
+                    }
+                    return *this;
+                }
+
+                PropertyCache& operator =(PropertyCache&& other) noexcept
+                {
+                    if (this != &other) {
+                        std::scoped_lock lock(mutex, other.mutex);
+                        assign(std::move(other));
+                    }
+                    return *this;
+                }
+
+                template<class Other>
+                void assign(Other&& other)
+                {
+                    // A copy shares the stamp, so later mutations of either side need a new one.
+                    other.observed.store(true, std::memory_order_relaxed);
+                    observed.store(true, std::memory_order_relaxed);
+                    diagonal = std::forward<Other>(other).diagonal;
+                    trace = other.trace;
+                    symmetric = other.symmetric;
+                    lower = other.lower;
+                    upper = other.upper;
+                    for (size_t mode = 0; mode < 2; ++mode) {
+                        frobenius[mode] = other.frobenius[mode];
+                        norm1[mode] = other.norm1[mode];
+                        normInf[mode] = other.normInf[mode];
+                    }
+                }
+
+                mutable std::mutex mutex;
+                mutable std::atomic<bool> observed{ false }; // stamp seen by a cache entry or getVersion()
+
+                CacheSlot<std::vector<T>> diagonal;
+                CacheSlot<T> trace;
+                CacheSlot<Real<T>> frobenius[2];
+                CacheSlot<Real<T>> norm1[2];
+                CacheSlot<Real<T>> normInf[2];
+                CacheSlot<bool> symmetric;
+                CacheSlot<bool> lower;
+                CacheSlot<bool> upper;
+            };
+
+            struct PropertyAccess; // lets Reductions.hpp use the cache of a Matrix
+
+        }; // end namespace detail
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __PROPERTYCACHE_HPP__ */
@@ -0,0 +1,714 @@
+#ifndef __REDUCTIONS_HPP__
+#define __REDUCTIONS_HPP__
+
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Parallel.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Direction of an axis-wise reduction.
+         * Rows yields one value per row, Cols one value per column.
+         */
+        enum class Axis
+        {
+            Rows,
+            Cols
+        };
+
+
+        namespace detail
+        {
+            constexpr size_t kReductionLanes = 8; // independent accumulators per leaf, one SIMD register of floats
+            constexpr size_t kReductionLeaf = 4096; // elements per leaf in deterministic mode
+
+            inline std::atomic<bool>& deterministicReductionsFlag()
+            {
+                static std::atomic<bool> flag{ false };
+                return flag;
+            }
+
+            template<class T>
+            inline T absSquare(const T& x)
+            {
+                return x * x;
+            }
+
+            template<class T>
+            inline T absSquare(const std::complex<T>& x)
+            {
+                return std::norm(x);
+            }
+
+
+            /**
+            * @brief Sum of map(data[i]) over n contiguous elements.
+            * Element i goes to accumulator i % kReductionLanes, so the compiler can keep the lanes
+            * in one vector register without reassociating, and the lanes are folded pairwise.
+            * The result depends only on n, never on alignment or thread count.
+            */
+
+            template<class R, class T, class Map>
+            inline R laneSum(const T* data, size_t n, Map map)
+            {
+                R lanes[kReductionLanes] = {};
+                size_t i = 0;
+                for (; i + kReductionLanes <= n; i += kReductionLanes) {
+                    for (size_t l = 0; l < kReductionLanes; ++l) {
+                        lanes[l] += map(data[i + l]);
+                    }
+                }
+                for (size_t l = 0; i < n; ++i, ++l) {
+                    lanes[l] += map(data[i]);
+                }
+                for (size_t width = kReductionLanes / 2; width > 0; width /= 2) {
+                    for (size_t l = 0; l < width; ++l) {
+                        lanes[l] += lanes[l + width];
+                    }
+                }
+                return lanes[0];
+            }
+
+
+            /**
+            * @brief Smallest (or largest with Greater) map(data[i]) over n > 0 contiguous elements,
+            * using the same lane layout as laneSum().
+            */
+
+            template<class R, class T, class Map, class Better>
+            inline R laneBest(const T* data, size_t n, Map map, Better better)
+            {
+                R lanes[kReductionLanes];
+                for (size_t l = 0; l < kReductionLanes; ++l) {
+                    lanes[l] = map(data[0]);
+                }
+                size_t i = 0;
+                for (; i + kReductionLanes <= n; i += kReductionLanes) {
+                    for (size_t l = 0; l < kReductionLanes; ++l) {
+                        const R x = map(data[i + l]);
+                        lanes[l] = better(x, lanes[l]) ? x : lanes[l];
+                    }
+                }
+                for (size_t l = 0; i < n; ++i, ++l) {
+                    const R x = map(data[i]);
+                    lanes[l] = better(x, lanes[l]) ? x : lanes[l];
+                }
+                R best = lanes[0];
+                for (size_t l = 1; l < kReductionLanes; ++l) {
+                    best = better(lanes[l], best) ? lanes[l] : best;
+                }
+                return best;
+            }
+
+
+            /**
+            * @brief Folds partial results pairwise, neighbours first, in a fixed order.
+            */
+
+            template<class R, class Combine>
+            inline R treeReduce(std::vector<R>& partials, Combine combine)
+            {
+                size_t count = partials.size();
+                while (count > 1) {
+                    const size_t half = count / 2;
+                    for (size_t i = 0; i < half; ++i) {
+                        partials[i] = combine(partials[2 * i], partials[2 * i + 1]);
+                    }
+                    if (count % 2 != 0) {
+                        partials[half] = std::move(partials[count - 1]);
+                    }
+                    count = (count + 1) / 2;
+                }
+                return std::move(partials[0]);
+            }
+
+
+            /**
+            * @brief Reduces rows [0, rows) to a single R.
+            * The rows are cut into blocks, leaf(lo, hi) reduces each block in parallel and the
+            * block results are folded by treeReduce(). In deterministic mode the blocks hold about
+            * kReductionLeaf elements each, independent of the thread count, so the result is
+            * bitwise reproducible on any machine. Otherwise there is one block per parallelFor()
+            * chunk.
+            *
+            * @param rows Number of rows.
+            * @param cols Number of columns, only used to size the blocks.
+            * @param identity Result for zero rows, also the initial block value.
+            */
+
+            template<class R, class Leaf, class Combine>
+            inline R reduceRows(size_t rows, size_t cols, const R& identity, Leaf leaf, Combine combine)
+            {
+                if (rows == 0) {
+                    return identity;
+                }
+                size_t blockRows = 0;
+                size_t grain = 1;
+                if (deterministicReductionsFlag().load(std::memory_order_relaxed)) {
+                    blockRows = std::max<size_t>(kReductionLeaf / std::max<size_t>(cols, 1), 1);
+                    grain = std::max<size_t>(kParallelGrainRows / blockRows, 1);
+                }
+                else {
+                    blockRows = (rows + chunkCount(rows, kParallelGrainRows) - 1) / chunkCount(rows, kParallelGrainRows);
+                }
+                const size_t blocks = (rows + blockRows - 1) / blockRows;
+
+                std::vector<R> partials(blocks, identity);
+                parallelFor(0, blocks, grain, [&](size_t lo, size_t hi) {
+                    for (size_t b = lo; b < hi; ++b) {
+                        partials[b] = leaf(b * blockRows, std::min((b + 1) * blockRows, rows));
+                    }
+                });
+                return treeReduce(partials, combine);
+            }
+
+
+            /**
+            * @brief Sums map(m(i, j)) over the whole matrix.
+            */
+
+            template<class R, class T, class Map>
+            inline R sumMapped(const Matrix<T>& m, Map map)
+            {
+                const size_t cols = m.getCols();
+                return reduceRows<R>(m.getRows(), cols, R{},
+                    [&](size_t lo, size_t hi) {
+                        R partial{};
+                        for (size_t i = lo; i < hi; ++i) {
+                            partial += laneSum<R>(m.rowData(i), cols, map);
+                        }
+                        return partial;
+                    },
+                    [](const R& a, const R& b) { return a + b; });
+            }
+
+
+            /**
+            * @brief Sums map(m(i, j)) down each column, the rows of a block are added with
+            * contiguous, vectorizable loops.
+            */
+
+            template<class R, class T, class Map>
+            inline std::vector<R> columnSums(const Matrix<T>& m, Map map)
+            {
+                const size_t cols = m.getCols();
+                return reduceRows<std::vector<R>>(m.getRows(), cols, std::vector<R>(cols, R{}),
+                    [&](size_t lo, size_t hi) {
+                        std::vector<R> partial(cols, R{});
+                        for (size_t i = lo; i < hi; ++i) {
+                            const T* row = m.rowData(i);
+                            for (size_t j = 0; j < cols; ++j) {
+                                partial[j] += map(row[j]);
+                            }
+                        }
+                        return partial;
+                    },
+                    [cols](std::vector<R> a, const std::vector<R>& b) {
+                        for (size_t j = 0; j < cols; ++j) {
+                            a[j] += b[j];
+                        }
+                        return a;
+                    });
+            }
+
+
+            /**
+            * @brief Applies rowOp(row pointer, cols) to every row in parallel.
+            */
+
+            template<class R, class T, class RowOp>
+            inline std::vector<R> perRow(const Matrix<T>& m, RowOp rowOp)
+            {
+                const size_t cols = m.getCols();
+                std::vector<R> result(m.getRows());
+                parallelFor(0, m.getRows(), kParallelGrainRows, [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        result[i] = rowOp(m.rowData(i), cols);
+                    }
+                });
+                return result;
+            }
+
+
+            // Value and position of an extreme element, ties go to the lower position.
+            template<class T>
+            struct Extreme
+            {
+                T value{};
+                size_t row = 0;
+                size_t col = 0;
+            };
+
+
+            /**
+            * @brief Position of the first extreme element of the matrix.
+            * Each row's extreme is found by laneBest(), the row is scanned again only when it beats
+            * the best of its block.
+            */
+
+            template<class T, class Better>
+            inline Extreme<T> extreme(const Matrix<T>& m, Better better)
+            {
+                const size_t cols = m.getCols();
+                if (m.getRows() == 0 || cols == 0) {
+                    throw std::invalid_argument("Reduction requires a non-empty matrix!");
+                }
+                auto identity = [](const T& x) { return x; };
+                auto pick = [&better](const Extreme<T>& a, const Extreme<T>& b) {
+                    return better(b.value, a.value) ? b : a; // a always precedes b
+                };
+                Extreme<T> first{ m.rowData(0)[0], 0, 0 };
+                return reduceRows<Extreme<T>>(m.getRows(), cols, first,
+                    [&](size_t lo, size_t hi) {
+                        Extreme<T> best{ m.rowData(lo)[0], lo, 0 };
+                        for (size_t i = lo; i < hi; ++i) {
+                            const T* row = m.rowData(i);
+                            const T value = laneBest<T>(row, cols, identity, better);
+                            if (i == lo || better(value, best.value)) {
+                                best = { value, i, static_cast<size_t>(std::find(row, row + cols, value) - row) };
+                            }
+                        }
+                        return best;
+                    },
+                    pick);
+            }
+
+
+            /**
+            * @brief Extreme element of every row or column with its index along the axis.
+            */
+
+            template<class T, class Better>
+            inline std::vector<std::pair<T, size_t>> axisExtremes(const Matrix<T>& m, Axis axis, Better better)
+            {
+                const size_t rows = m.getRows();
+                const size_t cols = m.getCols();
+                using Entry = std::pair<T, size_t>;
+                if (rows == 0 || cols == 0) {
+                    throw std::invalid_argument("Reduction requires a non-empty matrix!");
+                }
+
+                if (axis == Axis::Rows) {
+                    return perRow<Entry>(m, [&better](const T* row, size_t n) {
+                        const T value = laneBest<T>(row, n, [](const T& x) { return x; }, better);
+                        return Entry{ value, static_cast<size_t>(std::find(row, row + n, value) - row) };
+                    });
+                }
+
+                std::vector<Entry> first(cols);
+                for (size_t j = 0; j < cols; ++j) {
+                    first[j] = { m.rowData(0)[j], 0 };
+                }
+                return reduceRows<std::vector<Entry>>(rows, cols, first,
+                    [&](size_t lo, size_t hi) {
+                        std::vector<T> value(m.rowData(lo), m.rowData(lo) + cols);
+                        std::vector<size_t> index(cols, lo);
+                        for (size_t i = lo + 1; i < hi; ++i) {
+                            const T* row = m.rowData(i);
+                            for (size_t j = 0; j < cols; ++j) {
+                                const bool take = better(row[j], value[j]);
+                                value[j] = take ? row[j] : value[j];
+                                index[j] = take ? i : index[j];
+                            }
+                        }
+                        std::vector<Entry> partial(cols);
+                        for (size_t j = 0; j < cols; ++j) {
+                            partial[j] = { value[j], index[j] };
+                        }
+                        return partial;
+                    },
+                    [&better, cols](std::vector<Entry> a, const std::vector<Entry>& b) {
+                        for (size_t j = 0; j < cols; ++j) {
+                            if (better(b[j].first, a[j].first)) {
+                                a[j] = b[j];
+                            }
+                        }
+                        return a;
+                    });
+            }
+
+            template<class T>
+            inline std::vector<T> extremeValues(const std::vector<std::pair<T, size_t>>& entries)
+            {
+                std::vector<T> values(entries.size());
+                std::transform(entries.begin(), entries.end(), values.begin(), [](const auto& e) { return e.first; });
+                return values;
+            }
+
+            template<class T>
+            inline std::vector<size_t> extremeIndices(const std::vector<std::pair<T, size_t>>& entries)
+            {
+                std::vector<size_t> indices(entries.size());
+                std::transform(entries.begin(), entries.end(), indices.begin(), [](const auto& e) { return e.second; });
+                return indices;
+            }
+
+            /**
+            * @brief Routes the full-matrix reductions through the property cache of the matrix.
+            * Norms are cached per reduction mode, since the two modes may round differently.
+            */
+            struct PropertyAccess
+            {
+                template<class T, class F>
+                static T trace(const Matrix<T>& m, F compute)
+                {
+                    return m.cached(m.m_cache.trace, compute);
+                }
+
+                template<class T, class F>
+                static Real<T> normFrobenius(const Matrix<T>& m, F compute)
+                {
+                    return m.cached(m.m_cache.frobenius[mode()], compute);
+                }
+
+                template<class T, class F>
+                static Real<T> norm1(const Matrix<T>& m, F compute)
+                {
+                    return m.cached(m.m_cache.norm1[mode()], compute);
+                }
+
+                template<class T, class F>
+                static Real<T> normInf(const Matrix<T>& m, F compute)
+                {
+                    return m.cached(m.m_cache.normInf[mode()], compute);
+                }
+
+            private:
+                static size_t mode()
+                {
+                    return deterministicReductionsFlag().load(std::memory_order_relaxed) ? 1 : 0;
+                }
+            };
+
+            template<class T>
+            inline bool less(const T& a, const T& b)
+            {
+                return a < b;
+            }
+
+            template<class T>
+            inline bool greater(const T& a, const T& b)
+            {
+                return b < a;
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Makes sums, means and norms bitwise reproducible regardless of thread count.
+        * Every reduction is then split into fixed leaves of about detail::kReductionLeaf elements
+        * that are folded in a fixed tree. Minima, maxima and their positions are exact and ignore
+        * the setting. Off by default.
+        */
+
+        inline void setDeterministicReductions(bool enabled)
+        {
+            detail::deterministicReductionsFlag().store(enabled);
+        }
+
+        inline bool getDeterministicReductions()
+        {
+            return detail::deterministicReductionsFlag().load();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Full reductions
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Sum of all elements.
+        *
+        * Example usage:
+        * \code
+        * NumeriCore::Matrix::setDeterministicReductions(true);
+        * double total = NumeriCore::Matrix::sum(a);
+        * std::vector<double> colSums = NumeriCore::Matrix::sum(a, NumeriCore::Matrix::Axis::Cols);
+        * \endcode
+        *
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        T sum(const Matrix<T>& m)
+        {
+            return detail::sumMapped<T>(m, [](const T& x) { return x; });
+        }
+
+        /**
+        * @brief Mean of all elements.
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        T mean(const Matrix<T>& m)
+        {
+            if (m.getRows() == 0 || m.getCols() == 0) {
+                throw std::invalid_argument("Reduction requires a non-empty matrix!");
+            }
+            return sum(m) / static_cast<T>(m.getRows() * m.getCols());
+        }
+
+        /**
+        * @brief Frobenius norm, the square root of the sum of squared magnitudes.
+        * Cached by the matrix until its next mutation, like norm1(), normInf() and trace().
+        */
+
+        template<class T>
+        detail::Real<T> normFrobenius(const Matrix<T>& m)
+        {
+            using R = detail::Real<T>;
+            return detail::PropertyAccess::normFrobenius(m, [&m]() {
+                return static_cast<R>(std::sqrt(detail::sumMapped<R>(m, [](const T& x) { return static_cast<R>(detail::absSquare(x)); })));
+            });
+        }
+
+        /**
+        * @brief Induced 1-norm, the largest column sum of magnitudes.
+        */
+
+        template<class T>
+        detail::Real<T> norm1(const Matrix<T>& m)
+        {
+            using R = detail::Real<T>;
+            return detail::PropertyAccess::norm1(m, [&m]() {
+                const std::vector<R> sums = detail::columnSums<R>(m, [](const T& x) { return static_cast<R>(std::abs(x)); });
+                return sums.empty() ? R{} : *std::max_element(sums.begin(), sums.end());
+            });
+        }
+
+        /**
+        * @brief Induced infinity-norm, the largest row sum of magnitudes.
+        */
+
+        template<class T>
+        detail::Real<T> normInf(const Matrix<T>& m)
+        {
+            using R = detail::Real<T>;
+            return detail::PropertyAccess::normInf(m, [&m]() {
+                const std::vector<R> sums = detail::perRow<R>(m, [](const T* row, size_t n) {
+                    return detail::laneSum<R>(row, n, [](const T& x) { return static_cast<R>(std::abs(x)); });
+                });
+                return sums.empty() ? R{} : *std::max_element(sums.begin(), sums.end());
+            });
+        }
+
+        /**
+        * @brief Smallest element. Elements are compared with operator<, NaN gives unspecified results.
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        T minElement(const Matrix<T>& m)
+        {
+            return detail::extreme(m, detail::less<T>).value;
+        }
+
+        /**
+        * @brief Largest element.
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        T maxElement(const Matrix<T>& m)
+        {
+            return detail::extreme(m, detail::greater<T>).value;
+        }
+
+        /**
+        * @brief Row and column of the first smallest element in row-major order.
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        std::pair<size_t, size_t> argMin(const Matrix<T>& m)
+        {
+            const auto e = detail::extreme(m, detail::less<T>);
+            return { e.row, e.col };
+        }
+
+        /**
+        * @brief Row and column of the first largest element in row-major order.
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        std::pair<size_t, size_t> argMax(const Matrix<T>& m)
+        {
+            const auto e = detail::extreme(m, detail::greater<T>);
+            return { e.row, e.col };
+        }
+
+        /**
+        * @brief Sum of the diagonal.
+        * @throw std::invalid_argument If the matrix is not square.
+        */
+
+        template<class T>
+        T trace(const Matrix<T>& m)
+        {
+            if (m.getRows() != m.getCols()) {
+                throw std::invalid_argument("Trace requires a square matrix!");
+            }
+            return detail::PropertyAccess::trace(m, [&m]() {
+                std::vector<T> diagonal(m.getRows());
+                for (size_t i = 0; i < diagonal.size(); ++i) {
+                    diagonal[i] = m.rowData(i)[i];
+                }
+                return detail::laneSum<T>(diagonal.data(), diagonal.size(), [](const T& x) { return x; });
+            });
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Axis-wise reductions, one value per row or per column
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        std::vector<T> sum(const Matrix<T>& m, Axis axis)
+        {
+            auto identity = [](const T& x) { return x; };
+            if (axis == Axis::Cols) {
+                return detail::columnSums<T>(m, identity);
+            }
+            return detail::perRow<T>(m, [&identity](const T* row, size_t n) { return detail::laneSum<T>(row, n, identity); });
+        }
+
+        /**
+        * @throw std::invalid_argument If the reduced axis has no elements.
+        */
+
+        template<class T>
+        std::vector<T> mean(const Matrix<T>& m, Axis axis)
+        {
+            const size_t count = axis == Axis::Rows ? m.getCols() : m.getRows();
+            if (count == 0) {
+                throw std::invalid_argument("Reduction requires a non-empty matrix!");
+            }
+            std::vector<T> result = sum(m, axis);
+            for (auto& value : result) {
+                value /= static_cast<T>(count);
+            }
+            return result;
+        }
+
+        /**
+        * @brief Euclidean norm of every row or column.
+        */
+
+        template<class T>
+        std::vector<detail::Real<T>> norm2(const Matrix<T>& m, Axis axis)
+        {
+            using R = detail::Real<T>;
+            auto square = [](const T& x) { return static_cast<R>(detail::absSquare(x)); };
+            std::vector<R> result = axis == Axis::Cols
+                ? detail::columnSums<R>(m, square)
+                : detail::perRow<R>(m, [&square](const T* row, size_t n) { return detail::laneSum<R>(row, n, square); });
+            for (auto& value : result) {
+                value = static_cast<R>(std::sqrt(value));
+            }
+            return result;
+        }
+
+        /**
+        * @brief Sum of magnitudes of every row or column.
+        */
+
+        template<class T>
+        std::vector<detail::Real<T>> norm1(const Matrix<T>& m, Axis axis)
+        {
+            using R = detail::Real<T>;
+            auto magnitude = [](const T& x) { return static_cast<R>(std::abs(x)); };
+            if (axis == Axis::Cols) {
+                return detail::columnSums<R>(m, magnitude);
+            }
+            return detail::perRow<R>(m, [&magnitude](const T* row, size_t n) { return detail::laneSum<R>(row, n, magnitude); });
+        }
+
+        /**
+        * @brief Largest magnitude of every row or column.
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        std::vector<detail::Real<T>> normInf(const Matrix<T>& m, Axis axis)
+        {
+            using R = detail::Real<T>;
+            if (m.getRows() == 0 || m.getCols() == 0) {
+                throw std::invalid_argument("Reduction requires a non-empty matrix!");
+            }
+            auto magnitude = [](const T& x) { return static_cast<R>(std::abs(x)); };
+            if (axis == Axis::Rows) {
+                return detail::perRow<R>(m, [&magnitude](const T* row, size_t n) {
+                    return detail::laneBest<R>(row, n, magnitude, detail::greater<R>);
+                });
+            }
+            const size_t cols = m.getCols();
+            return detail::reduceRows<std::vector<R>>(m.getRows(), cols, std::vector<R>(cols, R{}),
+                [&](size_t lo, size_t hi) {
+                    std::vector<R> partial(cols, R{});
+                    for (size_t i = lo; i < hi; ++i) {
+                        const T* row = m.rowData(i);
+                        for (size_t j = 0; j < cols; ++j) {
+                            partial[j] = std::max(partial[j], magnitude(row[j]));
+                        }
+                    }
+                    return partial;
+                },
+                [cols](std::vector<R> a, const std::vector<R>& b) {
+                    for (size_t j = 0; j < cols; ++j) {
+                        a[j] = std::max(a[j], b[j]);
+                    }
+                    return a;
+                });
+        }
+
+        /**
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        std::vector<T> minElement(const Matrix<T>& m, Axis axis)
+        {
+            return detail::extremeValues(detail::axisExtremes(m, axis, detail::less<T>));
+        }
+
+        template<class T>
+        std::vector<T> maxElement(const Matrix<T>& m, Axis axis)
+        {
+            return detail::extremeValues(detail::axisExtremes(m, axis, detail::greater<T>));
+        }
+
+        /**
+        * @brief Index of the first smallest element along each row (a column index) or down each
+        * column (a row index).
+        * @throw std::invalid_argument If the matrix is empty.
+        */
+
+        template<class T>
+        std::vector<size_t> argMin(const Matrix<T>& m, Axis axis)
+        {
+            return detail::extremeIndices(detail::axisExtremes(m, axis, detail::less<T>));
+        }
+
+        template<class T>
+        std::vector<size_t> argMax(const Matrix<T>& m, Axis axis)
+        {
+            return detail::extremeIndices(detail::axisExtremes(m, axis, detail::greater<T>));
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __REDUCTIONS_HPP__ */
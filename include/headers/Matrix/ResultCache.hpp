@@ -0,0 +1,460 @@
+#ifndef __RESULTCACHE_HPP__
+#define __RESULTCACHE_HPP__
+
+#include <list>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <typeinfo>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Matrix.hpp"
+#include "Gemm.hpp"
+#include "LU.hpp"
+#include "Cholesky.hpp"
+#include "HouseholderQR.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+        * @brief How a ResultCache recognizes an operand it has seen before.
+        *
+        * Version : by Matrix::getVersion(). O(1) per lookup. Hits for the same matrix or its
+        *           copies as long as they are not modified. The stamp only moves for writes made
+        *           after it was observed: a write through an element reference, row pointer or
+        *           iterator taken before the lookup leaves the stamp and can return a stale
+        *           result. Call markModified() after such writes, or use Content.
+        * Content : by a 128 bit hash of the elements, O(rows * cols) on every lookup. Also hits
+        *           for equal matrices built independently, e.g. the same input arriving again in a
+        *           later request, and sees every write. Not collision resistant against crafted
+        *           inputs.
+        */
+        enum class CacheKeying
+        {
+            Version,
+            Content
+        };
+
+        struct ResultCacheStats
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t evictions = 0;
+            size_t entries = 0;
+            size_t bytes = 0; // estimated size of the cached results
+        };
+
+
+        namespace detail
+        {
+            // Identity of one operand: stamp or content hash, plus shape and element type.
+            struct OperandKey
+            {
+                uint64_t high = 0;
+                uint64_t low = 0;
+                size_t rows = 0;
+                size_t cols = 0;
+                size_t type = 0;
+
+                bool operator==(const OperandKey& o) const
+                {
+                    return high == o.high && low == o.low && rows == o.rows && cols == o.cols && type == o.type;
+                }
+            };
+
+            struct ResultKey
+            {
+                uint64_t op = 0;
+                size_t result = 0; // typeid of the cached object
+                CacheKeying keying = CacheKeying::Version;
+                std::vector<OperandKey> operands;
+
+                bool operator==(const ResultKey& o) const
+                {
+                    return op == o.op && result == o.result && keying == o.keying && operands == o.operands;
+                }
+            };
+
+            inline uint64_t mix64(uint64_t x)
+            {
+                x ^= x >> 33;
+                x *= 0xFF51AFD7ED558CCDull;
+                x ^= x >> 33;
+                x *= 0xC4CEB9FE1A85EC53ull;
+                x ^= x >> 33;
+                return x;
+            }
+
+            inline uint64_t rotl64(uint64_t x, int r)
+            {
+                return (x << r) | (x >> (64 - r));
+            }
+
+            struct ResultKeyHash
+            {
+                size_t operator()(const ResultKey& key) const
+                {
+                    uint64_t h = mix64(key.op ^ key.result ^ static_cast<uint64_t>(key.keying));
+                    for (const auto& o : key.operands) {
+                        h = mix64(h ^ o.high) + o.low;
+                        h = mix64(h ^ (o.rows * 0x9E3779B97F4A7C15ull) ^ o.cols ^ o.type);
+                    }
+                    return static_cast<size_t>(h);
+                }
+            };
+
+            inline uint64_t nameHash(std::string_view name) // FNV-1a
+            {
+                uint64_t h = 0xCBF29CE484222325ull;
+                for (char c : name) {
+                    h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+                }
+                return h;
+            }
+
+            /**
+            * @brief 128 bit hash of the elements of a matrix.
+            * Every row is read as 64 bit words that feed four independent multiply-rotate lanes, so
+            * the loop carries no dependency between neighbouring words and runs at memory speed.
+            */
+
+            template<class T>
+            OperandKey contentKey(const Matrix<T>& m)
+            {
+                static_assert(std::is_trivially_copyable_v<T>, "Content keys need trivially copyable elements.");
+                constexpr uint64_t prime[4] = { 0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull };
+                uint64_t lane[4] = { prime[0], prime[1], prime[2], prime[3] };
+                const size_t bytes = m.getCols() * sizeof(T);
+                for (size_t i = 0; i < m.getRows(); ++i) {
+                    const unsigned char* row = reinterpret_cast<const unsigned char*>(m.rowData(i));
+                    size_t p = 0;
+                    for (; p + 32 <= bytes; p += 32) {
+                        for (size_t l = 0; l < 4; ++l) {
+                            uint64_t w;
+                            std::memcpy(&w, row + p + 8 * l, 8);
+                            lane[l] = rotl64(lane[l] ^ (w * prime[l]), 31) * prime[(l + 1) & 3];
+                        }
+                    }
+                    for (size_t l = 0; p < bytes; p += 8, ++l) {
+                        uint64_t w = 0;
+                        std::memcpy(&w, row + p, std::min<size_t>(8, bytes - p));
+                        lane[l] = rotl64(lane[l] ^ (w * prime[l]), 31) * prime[(l + 1) & 3];
+                    }
+                    lane[i & 3] ^= mix64(i + 1); // row boundaries
+                }
+                OperandKey key;
+                key.high = mix64(lane[0] + rotl64(lane[1], 17) + rotl64(lane[2], 29) + rotl64(lane[3], 43));
+                key.low = mix64(lane[3] ^ rotl64(lane[2], 13) ^ rotl64(lane[1], 37) ^ rotl64(lane[0], 53));
+                key.rows = m.getRows();
+                key.cols = m.getCols();
+                key.type = typeid(T).hash_code();
+                return key;
+            }
+
+            template<class T>
+            size_t matrixBytes(size_t rows, size_t cols)
+            {
+                return rows * (cols * sizeof(T) + sizeof(std::vector<T>)) + sizeof(Matrix<T>);
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Memoizes expensive results by the identity of their operands, so repeated
+        * identical work becomes a lookup.
+        *
+        * Results are kept until the estimated memory budget is exceeded, then the least recently
+        * used are evicted. Lookups are thread safe. A result that is being computed is shared:
+        * concurrent requests for it wait for the first one instead of computing it again. Results
+        * are immutable and shared, so eviction never invalidates a result handed out before.
+        *
+        * The cache is opt-in: Matrix::operator* and friends do not consult it, call its methods
+        * where recurring work is expected.
+        *
+        * Example usage:
+        * \code
+        * NumeriCore::Matrix::ResultCache cache(512 << 20, NumeriCore::Matrix::CacheKeying::Content);
+        * auto y = cache.multiply(weights, input);       // O(n^3) once per distinct input
+        * auto lu = cache.lu(system);                     // shared LU<double>, factorized once
+        * auto x = lu->solve(rhs);
+        * \endcode
+        */
+        class ResultCache
+        {
+        public:
+            explicit ResultCache(size_t budgetBytes = size_t(256) << 20, CacheKeying keying = CacheKeying::Version);
+
+            ResultCache(const ResultCache&) = delete;
+            ResultCache& operator=(const ResultCache&) = delete;
+
+            // //////////////////////////////////////////////////////////////////////////////////////////
+            //  Cached operations
+            // //////////////////////////////////////////////////////////////////////////////////////////
+
+            template<class T> Matrix<T> multiply(const Matrix<T>& a, const Matrix<T>& b); // a * b, a copy of the cached product
+            template<class T> Matrix<T> inverse(const Matrix<T>& a); // a^-1, via the cached LU of a
+            template<class T> std::shared_ptr<const LU<T>> lu(const Matrix<T>& a);
+            template<class T> std::shared_ptr<const Cholesky<T>> cholesky(const Matrix<T>& a);
+            template<class T> std::shared_ptr<const HouseholderQR<T>> qr(const Matrix<T>& a);
+
+            template<class R, class F, class... Operands>
+            std::shared_ptr<const R> memoize(std::string_view op, size_t bytes, F&& compute, const Operands&... operands);
+
+            // //////////////////////////////////////////////////////////////////////////////////////////
+            //  Budget and statistics
+            // //////////////////////////////////////////////////////////////////////////////////////////
+
+            void clear();
+            void setBudget(size_t budgetBytes); // evicts down to the new budget
+            size_t getBudget() const;
+            CacheKeying getKeying() const;
+            ResultCacheStats getStats() const;
+
+        private:
+            using Value = std::shared_ptr<const void>;
+
+            struct Entry
+            {
+                std::shared_future<Value> value;
+                size_t bytes = 0;
+                uint64_t id = 0;
+                std::list<detail::ResultKey>::iterator position;
+            };
+
+            template<class T> detail::OperandKey operandKey(const Matrix<T>& m);
+            void evictLocked(); // caller holds m_mutex
+
+            mutable std::mutex m_mutex;
+            size_t m_budget;
+            CacheKeying m_keying;
+            size_t m_bytes = 0;
+            uint64_t m_nextId = 0;
+            std::list<detail::ResultKey> m_order; // front is the most recently used
+            std::unordered_map<detail::ResultKey, Entry, detail::ResultKeyHash> m_entries;
+            ResultCacheStats m_stats;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // ResultCache class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        inline ResultCache::ResultCache(size_t budgetBytes, CacheKeying keying)
+            : m_budget(budgetBytes)
+            , m_keying(keying)
+        {
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // ResultCache class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Key of an operand under the keying of the cache. Content keys hash the elements
+        * on every lookup, the stamp cannot tell whether a kept reference wrote to them.
+        */
+
+        template<class T>
+        detail::OperandKey ResultCache::operandKey(const Matrix<T>& m)
+        {
+            if (m_keying == CacheKeying::Version) {
+                return { m.getVersion(), 0, m.getRows(), m.getCols(), typeid(T).hash_code() };
+            }
+            return detail::contentKey(m);
+        }
+
+        /**
+        * @brief Returns the cached result of op on the operands, computing it with compute() on a
+        * miss. Building block of the typed operations, usable for any deterministic function of
+        * matrices.
+        *
+        * @param op Name of the operation, part of the key.
+        * @param bytes Estimated size of the result, charged against the budget. A result larger
+        * than the whole budget is computed and returned without being cached.
+        * @param compute Callable returning the result as an R.
+        * @param operands The matrices the result depends on.
+        * @return The shared result. Exceptions of compute() are rethrown and nothing is cached.
+        * @tparam R Type of the result.
+        */
+
+        template<class R, class F, class... Operands>
+        std::shared_ptr<const R> ResultCache::memoize(std::string_view op, size_t bytes, F&& compute, const Operands&... operands)
+        {
+            detail::ResultKey key;
+            key.op = detail::nameHash(op);
+            key.result = typeid(R).hash_code();
+            key.keying = m_keying;
+            key.operands = { operandKey(operands)... };
+
+            std::promise<Value> promise;
+            std::shared_future<Value> pending;
+            uint64_t id = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const auto it = m_entries.find(key);
+                if (it != m_entries.end()) {
+                    ++m_stats.hits;
+                    m_order.splice(m_order.begin(), m_order, it->second.position);
+                    pending = it->second.value;
+                }
+                else {
+                    ++m_stats.misses;
+                    if (bytes <= m_budget) {
+                        id = ++m_nextId;
+                        m_order.push_front(key);
+                        Entry entry;
+                        entry.value = promise.get_future().share();
+                        entry.bytes = bytes;
+                        entry.id = id;
+                        entry.position = m_order.begin();
+                        m_entries.emplace(key, std::move(entry));
+                        m_bytes += bytes;
+                        evictLocked();
+                    }
+                }
+            }
+
+            if (pending.valid()) {
+                return std::static_pointer_cast<const R>(pending.get());
+            }
+            if (id == 0) {
+                return std::make_shared<const R>(compute()); // larger than the budget
+            }
+
+            try {
+                std::shared_ptr<const R> result = std::make_shared<const R>(compute());
+                promise.set_value(result);
+                return result;
+            }
+            catch (...) {
+                promise.set_exception(std::current_exception());
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const auto it = m_entries.find(key);
+                if (it != m_entries.end() && it->second.id == id) { // not evicted or replaced meanwhile
+                    m_bytes -= it->second.bytes;
+                    m_order.erase(it->second.position);
+                    m_entries.erase(it);
+                }
+                throw;
+            }
+        }
+
+        /**
+        * @brief Product a * b through gemm(). The returned copy keeps the stamp of the cached
+        * product, so it keys further cached products in O(1) until it is modified.
+        * @throws std::invalid_argument if the shapes do not match.
+        */
+
+        template<class T>
+        Matrix<T> ResultCache::multiply(const Matrix<T>& a, const Matrix<T>& b)
+        {
+            if (a.getCols() != b.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            return *memoize<Matrix<T>>("multiply", detail::matrixBytes<T>(a.getRows(), b.getCols()), [&]() {
+                Matrix<T> c(a.getRows(), b.getCols(), zeroFill);
+                gemm(static_cast<T>(1), a, b, static_cast<T>(0), c);
+                return c;
+            }, a, b);
+        }
+
+        /**
+        * @brief Inverse of a square matrix, computed from lu(a) so a cached factorization is reused.
+        * @throws std::invalid_argument if the matrix is not square, as LU.
+        * @throws std::runtime_error if the matrix is singular, as LU.
+        */
+
+        template<class T>
+        Matrix<T> ResultCache::inverse(const Matrix<T>& a)
+        {
+            return *memoize<Matrix<T>>("inverse", detail::matrixBytes<T>(a.getRows(), a.getCols()), [&]() {
+                return lu(a)->inverse();
+            }, a);
+        }
+
+        template<class T>
+        std::shared_ptr<const LU<T>> ResultCache::lu(const Matrix<T>& a)
+        {
+            const size_t bytes = detail::matrixBytes<T>(a.getRows(), a.getCols()) + a.getRows() * sizeof(size_t);
+            return memoize<LU<T>>("lu", bytes, [&]() { return LU<T>(a); }, a);
+        }
+
+        template<class T>
+        std::shared_ptr<const Cholesky<T>> ResultCache::cholesky(const Matrix<T>& a)
+        {
+            const size_t bytes = a.getRows() * (a.getRows() + 1) / 2 * sizeof(T) + sizeof(Cholesky<T>);
+            return memoize<Cholesky<T>>("cholesky", bytes, [&]() { return Cholesky<T>(a); }, a);
+        }
+
+        template<class T>
+        std::shared_ptr<const HouseholderQR<T>> ResultCache::qr(const Matrix<T>& a)
+        {
+            const size_t bytes = detail::matrixBytes<T>(a.getRows(), a.getCols()) + a.getCols() * a.getCols() * sizeof(T);
+            return memoize<HouseholderQR<T>>("qr", bytes, [&]() { return HouseholderQR<T>(a); }, a);
+        }
+
+        /**
+        * @brief Drops the least recently used results until the estimate fits the budget. Results
+        * still being computed may be dropped too, their callers keep them.
+        */
+
+        inline void ResultCache::evictLocked()
+        {
+            while (m_bytes > m_budget && !m_order.empty()) {
+                const auto it = m_entries.find(m_order.back());
+                m_bytes -= it->second.bytes;
+                m_entries.erase(it);
+                m_order.pop_back();
+                ++m_stats.evictions;
+            }
+        }
+
+        inline void ResultCache::clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.clear();
+            m_order.clear();
+            m_bytes = 0;
+        }
+
+        inline void ResultCache::setBudget(size_t budgetBytes)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_budget = budgetBytes;
+            evictLocked();
+        }
+
+        inline size_t ResultCache::getBudget() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_budget;
+        }
+
+        inline CacheKeying ResultCache::getKeying() const
+        {
+            return m_keying;
+        }
+
+        inline ResultCacheStats ResultCache::getStats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ResultCacheStats stats = m_stats;
+            stats.entries = m_entries.size();
+            stats.bytes = m_bytes;
+            return stats;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __RESULTCACHE_HPP__ */
@@ -0,0 +1,238 @@
+#ifndef __SHAREDMATRIX_HPP__
+#define __SHAREDMATRIX_HPP__
+
+#include <atomic>
+#include <utility>
+#include <ostream>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Matrix handle with reference-counted, copy-on-write storage.
+         * Copies share one buffer and cost O(1), the first mutation through a handle whose buffer
+         * is shared copies it. Rows, diagonal and name are all shared and copied together.
+         *
+         * Thread safety follows std::shared_ptr: different handles to the same buffer may be
+         * read, copied, destroyed and mutated from different threads without locking, only a
+         * single handle must not be mutated while another thread uses that same handle. A
+         * reference returned by mutate() stays private to the handle until the handle is copied.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::SharedMatrix<double> features(std::move(large));
+         * for (auto& worker : workers) {
+         *     worker.input = features;  // no element is copied
+         * }
+         * features.mutate().getElement(0, 0) = 1.0;  // detaches from the workers' copies
+         * \endcode
+         */
+        template<class T>
+        class SharedMatrix
+        {
+        public:
+            SharedMatrix();
+            explicit SharedMatrix(Matrix<T> matrix); // takes the matrix over
+            SharedMatrix(const SharedMatrix& other) noexcept;
+            SharedMatrix(SharedMatrix&& other) noexcept; // leaves other empty
+
+            SharedMatrix& operator =(SharedMatrix other) noexcept;
+
+            ~SharedMatrix();
+
+        public:
+            const Matrix<T>& get() const; // read-only view, never copies
+            operator const Matrix<T>&() const; // same as get()
+            Matrix<T>& mutate(); // writable matrix, copies the buffer first if it is shared
+
+            T getElement(size_t row, size_t col) const; // get element at index row, column
+            void setElement(size_t row, size_t col, const T& value); // set element, copies first if shared
+            const T* rowData(size_t row) const; // contiguous elements of a row, unchecked
+            size_t getRows() const; // get number of rows
+            size_t getCols() const; // get number of cols
+
+            bool isShared() const; // true if another handle uses the same buffer
+            size_t useCount() const; // handles using the buffer, 0 for an empty handle
+
+            template<class U>
+            friend std::ostream& operator<<(std::ostream& os, const SharedMatrix<U>& m);
+
+        private:
+            struct Block
+            {
+                explicit Block(Matrix<T>&& m) : matrix(std::move(m)) {}
+
+                std::atomic<size_t> references{ 1 };
+                Matrix<T> matrix;
+            };
+
+            static const Matrix<T>& empty();
+            void release() noexcept;
+
+        private:
+            Block* m_block = nullptr;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SharedMatrix class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        SharedMatrix<T>::SharedMatrix()
+            : m_block(new Block(Matrix<T>(0, 0)))
+        {
+        }
+
+        template<class T>
+        SharedMatrix<T>::SharedMatrix(Matrix<T> matrix)
+            : m_block(new Block(std::move(matrix)))
+        {
+        }
+
+        template<class T>
+        SharedMatrix<T>::SharedMatrix(const SharedMatrix& other) noexcept
+            : m_block(other.m_block)
+        {
+            if (m_block) {
+                m_block->references.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        template<class T>
+        SharedMatrix<T>::SharedMatrix(SharedMatrix&& other) noexcept
+            : m_block(std::exchange(other.m_block, nullptr))
+        {
+        }
+
+        template<class T>
+        SharedMatrix<T>& SharedMatrix<T>::operator =(SharedMatrix other) noexcept
+        {
+            std::swap(m_block, other.m_block);
+            return *this;
+        }
+
+        template<class T>
+        SharedMatrix<T>::~SharedMatrix()
+        {
+            release();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SharedMatrix class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Drops this handle's reference.
+        * The decrement is acq_rel so every access made through other handles happens before the
+        * buffer is freed or written in place by the last owner.
+        */
+
+        template<class T>
+        void SharedMatrix<T>::release() noexcept
+        {
+            if (m_block && m_block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete m_block;
+            }
+            m_block = nullptr;
+        }
+
+        template<class T>
+        const Matrix<T>& SharedMatrix<T>::empty()
+        {
+            static const Matrix<T> matrix(0, 0);
+            return matrix;
+        }
+
+        template<class T>
+        const Matrix<T>& SharedMatrix<T>::get() const
+        {
+            return m_block ? m_block->matrix : empty();
+        }
+
+        template<class T>
+        SharedMatrix<T>::operator const Matrix<T>&() const
+        {
+            return get();
+        }
+
+        /**
+        * @brief Returns the matrix for writing.
+        * If other handles share the buffer it is copied first and this handle moves to the copy,
+        * the other handles keep the original unchanged.
+        */
+
+        template<class T>
+        Matrix<T>& SharedMatrix<T>::mutate()
+        {
+            if (!m_block) {
+                m_block = new Block(Matrix<T>(0, 0));
+            }
+            else if (m_block->references.load(std::memory_order_acquire) != 1) {
+                Block* copy = new Block(Matrix<T>(m_block->matrix));
+                release();
+                m_block = copy;
+            }
+            return m_block->matrix;
+        }
+
+        template<class T>
+        T SharedMatrix<T>::getElement(size_t row, size_t col) const
+        {
+            return get().getElement(row, col);
+        }
+
+        template<class T>
+        void SharedMatrix<T>::setElement(size_t row, size_t col, const T& value)
+        {
+            if (row >= getRows() || col >= getCols()) {
+                throw std::out_of_range("Index out of range."); // before mutate() copies anything
+            }
+            mutate().getElement(row, col) = value;
+        }
+
+        template<class T>
+        const T* SharedMatrix<T>::rowData(size_t row) const
+        {
+            return get().rowData(row);
+        }
+
+        template<class T>
+        size_t SharedMatrix<T>::getRows() const
+        {
+            return get().getRows();
+        }
+
+        template<class T>
+        size_t SharedMatrix<T>::getCols() const
+        {
+            return get().getCols();
+        }
+
+        template<class T>
+        bool SharedMatrix<T>::isShared() const
+        {
+            return useCount() > 1;
+        }
+
+        template<class T>
+        size_t SharedMatrix<T>::useCount() const
+        {
+            return m_block ? m_block->references.load(std::memory_order_acquire) : 0;
+        }
+
+        template<class U>
+        std::ostream& operator<<(std::ostream& os, const SharedMatrix<U>& m)
+        {
+            return os << m.get();
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __SHAREDMATRIX_HPP__ */
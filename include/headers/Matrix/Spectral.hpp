@@ -0,0 +1,752 @@
+#ifndef __SPECTRAL_HPP__
+#define __SPECTRAL_HPP__
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+#include "Krylov.hpp"
+#include "HouseholderQR.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Which end of the spectrum lanczos() returns.
+         * Block power iteration always converges to the eigenvalues of largest magnitude.
+         */
+        enum class Spectrum
+        {
+            LargestAlgebraic,
+            SmallestAlgebraic,
+            LargestMagnitude
+        };
+
+        /**
+         * @brief Stopping criteria of the partial eigenvalue and singular value solvers.
+         *
+         * tolerance     : an eigenpair has converged once ||A x - theta x|| <= tolerance * |theta|, a
+         *                 singular value once it changes by at most tolerance relative between passes.
+         * maxIterations : budget of operator applications, vectors for lanczos(), blocks otherwise.
+         * subspace      : Lanczos basis size before a restart, 0 picks max(2k + 1, 20).
+         * oversampling  : extra columns carried by block power iteration and randomized SVD.
+         * target        : wanted eigenvalues of lanczos().
+         * seed          : seed of the random start vectors, equal seeds reproduce a run.
+         */
+        struct SpectralConfig
+        {
+            double tolerance = 1e-8;
+            size_t maxIterations = 1000;
+            size_t subspace = 0;
+            size_t oversampling = 10;
+            Spectrum target = Spectrum::LargestAlgebraic;
+            unsigned seed = 0;
+        };
+
+        template<class T>
+        struct EigenResult
+        {
+            std::vector<T> values;       // k eigenvalues in target order
+            Matrix<T> vectors;           // n x k, column i belongs to values[i]
+            size_t iterations = 0;       // operator applications
+            bool converged = false;
+            std::vector<double> residuals; // relative residual of every pair
+        };
+
+        template<class T>
+        struct SvdResult
+        {
+            std::vector<T> values;       // k singular values, descending
+            Matrix<T> u;                 // m x k left singular vectors
+            Matrix<T> v;                 // n x k right singular vectors
+            size_t iterations = 0;       // block operator applications
+            bool converged = false;
+            std::vector<double> residuals; // relative change of every singular value in the last pass
+        };
+
+
+        /**
+         * @brief Block operator applying a vector operator column by column.
+         * Lets the block solvers take the same matrix-free callables as the Krylov solvers,
+         * void(const std::vector<T>& x, std::vector<T>& y).
+         */
+        template<class Operator>
+        struct ColumnwiseOperator
+        {
+            Operator op;
+
+            template<class T>
+            void operator()(const Matrix<T>& x, Matrix<T>& y) const
+            {
+                std::vector<T> column(x.getRows());
+                std::vector<T> result;
+                for (size_t j = 0; j < x.getCols(); ++j) {
+                    for (size_t i = 0; i < x.getRows(); ++i) {
+                        column[i] = x.rowData(i)[j];
+                    }
+                    op(column, result);
+                    for (size_t i = 0; i < y.getRows(); ++i) {
+                        y.rowData(i)[j] = result[i];
+                    }
+                }
+            }
+        };
+
+        template<class Operator>
+        ColumnwiseOperator<Operator> columnwise(Operator op)
+        {
+            return { std::move(op) };
+        }
+
+
+        namespace detail
+        {
+            // ////////////////////////////////////////////////////////////////////////////////////////
+            // Dense kernels on the small projected problems, all row-major
+            // ////////////////////////////////////////////////////////////////////////////////////////
+
+            /**
+            * @brief Eigenvalues of the symmetric n x n matrix a by cyclic Jacobi rotations.
+            * s receives the eigenvectors as columns. a is destroyed. Quadratically convergent,
+            * O(n^3) per sweep, meant for the projected problems of a few dozen rows.
+            */
+
+            template<class T>
+            std::vector<T> symmetricEigen(std::vector<T> a, size_t n, std::vector<T>& s)
+            {
+                s.assign(n * n, static_cast<T>(0));
+                for (size_t i = 0; i < n; ++i) {
+                    s[i * n + i] = static_cast<T>(1);
+                }
+                const T eps = std::numeric_limits<T>::epsilon();
+                for (size_t sweep = 0; sweep < 64; ++sweep) {
+                    T off = static_cast<T>(0);
+                    T total = static_cast<T>(0);
+                    for (size_t i = 0; i < n; ++i) {
+                        for (size_t j = 0; j < n; ++j) {
+                            total += a[i * n + j] * a[i * n + j];
+                            off += i != j ? a[i * n + j] * a[i * n + j] : static_cast<T>(0);
+                        }
+                    }
+                    if (off <= eps * eps * total) {
+                        break;
+                    }
+                    for (size_t p = 0; p + 1 < n; ++p) {
+                        for (size_t q = p + 1; q < n; ++q) {
+                            const T apq = a[p * n + q];
+                            if (apq == static_cast<T>(0)) {
+                                continue;
+                            }
+                            const T theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+                            const T t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                            const T c = 1 / std::sqrt(t * t + 1);
+                            const T sn = t * c;
+                            for (size_t r = 0; r < n; ++r) {
+                                const T arp = a[r * n + p];
+                                const T arq = a[r * n + q];
+                                a[r * n + p] = c * arp - sn * arq;
+                                a[r * n + q] = sn * arp + c * arq;
+                            }
+                            for (size_t r = 0; r < n; ++r) {
+                                const T apr = a[p * n + r];
+                                const T aqr = a[q * n + r];
+                                a[p * n + r] = c * apr - sn * aqr;
+                                a[q * n + r] = sn * apr + c * aqr;
+                            }
+                            for (size_t r = 0; r < n; ++r) {
+                                const T srp = s[r * n + p];
+                                const T srq = s[r * n + q];
+                                s[r * n + p] = c * srp - sn * srq;
+                                s[r * n + q] = sn * srp + c * srq;
+                            }
+                        }
+                    }
+                }
+                std::vector<T> values(n);
+                for (size_t i = 0; i < n; ++i) {
+                    values[i] = a[i * n + i];
+                }
+                return values;
+            }
+
+            /**
+            * @brief One-sided Jacobi SVD of the rows x cols matrix b, rows >= cols.
+            * Rotates pairs of columns of b until they are orthogonal, then b = U * diag(sigma) with
+            * U normalized in place and v (cols x cols) holds the right singular vectors. Columns
+            * come out sorted by descending singular value.
+            */
+
+            template<class T>
+            std::vector<T> jacobiSvd(std::vector<T>& b, size_t rows, size_t cols, std::vector<T>& v)
+            {
+                v.assign(cols * cols, static_cast<T>(0));
+                for (size_t i = 0; i < cols; ++i) {
+                    v[i * cols + i] = static_cast<T>(1);
+                }
+                const T eps = std::numeric_limits<T>::epsilon();
+                for (size_t sweep = 0; sweep < 64; ++sweep) {
+                    bool rotated = false;
+                    for (size_t p = 0; p + 1 < cols; ++p) {
+                        for (size_t q = p + 1; q < cols; ++q) {
+                            T alpha = 0, beta = 0, gamma = 0;
+                            for (size_t r = 0; r < rows; ++r) {
+                                const T bp = b[r * cols + p];
+                                const T bq = b[r * cols + q];
+                                alpha += bp * bp;
+                                beta += bq * bq;
+                                gamma += bp * bq;
+                            }
+                            if (std::abs(gamma) <= eps * std::sqrt(alpha * beta)) {
+                                continue;
+                            }
+                            rotated = true;
+                            const T zeta = (beta - alpha) / (2 * gamma);
+                            const T t = (zeta >= 0 ? 1 : -1) / (std::abs(zeta) + std::sqrt(zeta * zeta + 1));
+                            const T c = 1 / std::sqrt(t * t + 1);
+                            const T sn = t * c;
+                            for (size_t r = 0; r < rows; ++r) {
+                                const T bp = b[r * cols + p];
+                                const T bq = b[r * cols + q];
+                                b[r * cols + p] = c * bp - sn * bq;
+                                b[r * cols + q] = sn * bp + c * bq;
+                            }
+                            for (size_t r = 0; r < cols; ++r) {
+                                const T vp = v[r * cols + p];
+                                const T vq = v[r * cols + q];
+                                v[r * cols + p] = c * vp - sn * vq;
+                                v[r * cols + q] = sn * vp + c * vq;
+                            }
+                        }
+                    }
+                    if (!rotated) {
+                        break;
+                    }
+                }
+
+                std::vector<T> sigma(cols, static_cast<T>(0));
+                for (size_t r = 0; r < rows; ++r) {
+                    for (size_t j = 0; j < cols; ++j) {
+                        sigma[j] += b[r * cols + j] * b[r * cols + j];
+                    }
+                }
+                std::vector<size_t> order(cols);
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return sigma[x] > sigma[y]; });
+
+                std::vector<T> sorted(cols);
+                std::vector<T> u(rows * cols);
+                std::vector<T> w(cols * cols);
+                for (size_t j = 0; j < cols; ++j) {
+                    const size_t src = order[j];
+                    sorted[j] = std::sqrt(sigma[src]);
+                    const T scale = sorted[j] > 0 ? 1 / sorted[j] : 0;
+                    for (size_t r = 0; r < rows; ++r) {
+                        u[r * cols + j] = b[r * cols + src] * scale;
+                    }
+                    for (size_t r = 0; r < cols; ++r) {
+                        w[r * cols + j] = v[r * cols + src];
+                    }
+                }
+                b = std::move(u);
+                v = std::move(w);
+                return sorted;
+            }
+
+            // Indices of values in the order selected by target.
+            template<class T>
+            std::vector<size_t> spectrumOrder(const std::vector<T>& values, Spectrum target)
+            {
+                std::vector<size_t> order(values.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+                    switch (target) {
+                    case Spectrum::SmallestAlgebraic:
+                        return values[x] < values[y];
+                    case Spectrum::LargestMagnitude:
+                        return std::abs(values[x]) > std::abs(values[y]);
+                    default:
+                        return values[x] > values[y];
+                    }
+                });
+                return order;
+            }
+
+            template<class T>
+            std::vector<T> gaussianBlock(size_t rows, size_t cols, std::mt19937& gen)
+            {
+                std::normal_distribution<T> dis(0, 1);
+                std::vector<T> x(rows * cols);
+                for (auto& value : x) {
+                    value = dis(gen);
+                }
+                return x;
+            }
+
+            // Orthonormal basis of the columns of the rows x cols buffer x, through Householder QR.
+            template<class T>
+            void orthonormalize(std::vector<T>& x, size_t rows, size_t cols)
+            {
+                Matrix<T> m(rows, cols, zeroFill);
+                unpack(x.data(), cols, m);
+                x = pack(HouseholderQR<T>(m).getQ());
+            }
+
+            // C = A * B for row-major buffers, parallel over row bands of A.
+            template<class T>
+            std::vector<T> multiply(const std::vector<T>& a, const std::vector<T>& b, size_t m, size_t k, size_t n)
+            {
+                std::vector<T> c(m * n);
+                parallelFor(0, m, currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                    gemm(hi - lo, n, k, a.data() + lo * k, k, b.data(), n, c.data() + lo * n, n);
+                });
+                return c;
+            }
+
+            // A^T * B for row-major buffers, A is k x m and B is k x n.
+            template<class T>
+            std::vector<T> multiplyTransposed(const std::vector<T>& a, const std::vector<T>& b, size_t k, size_t m, size_t n)
+            {
+                std::vector<T> at(m * k);
+                for (size_t p = 0; p < k; ++p) {
+                    for (size_t i = 0; i < m; ++i) {
+                        at[i * k + p] = a[p * m + i];
+                    }
+                }
+                return multiply(at, b, m, k, n);
+            }
+
+            /**
+            * @brief Applies a block operator to a rows x cols buffer. x and y are Matrix
+            * buffers of the right shapes kept across calls.
+            */
+
+            template<class T, class BlockOperator>
+            std::vector<T> applyBlock(const BlockOperator& op, const std::vector<T>& in, Matrix<T>& x, Matrix<T>& y)
+            {
+                unpack(in.data(), x.getCols(), x);
+                op(static_cast<const Matrix<T>&>(x), y);
+                return pack(y);
+            }
+
+            // Dense block operator y = A * x on a packed copy of A.
+            template<class T>
+            struct DenseBlockOperator
+            {
+                std::vector<T> a;
+                size_t rows;
+                size_t cols;
+
+                void operator()(const Matrix<T>& x, Matrix<T>& y) const
+                {
+                    const std::vector<T> result = multiply(a, pack(x), rows, cols, x.getCols());
+                    unpack(result.data(), x.getCols(), y);
+                }
+            };
+
+            template<class T>
+            void checkSymmetric(const Matrix<T>& a)
+            {
+                if (!a.isSymmetric()) {
+                    throw std::invalid_argument("Symmetric eigensolvers require a symmetric matrix!");
+                }
+            }
+
+            inline void checkRank(size_t k, size_t n)
+            {
+                if (k == 0 || k > n) {
+                    throw std::invalid_argument("Number of wanted pairs must be between 1 and the operator size!");
+                }
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Lanczos
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief k eigenpairs of a symmetric operator by thick-restart Lanczos.
+        * The Krylov basis is extended to config.subspace vectors with full reorthogonalization
+        * (two Gram-Schmidt passes), so the projected matrix H = V^T A V stays accurate. Its
+        * Ritz pairs are computed by Jacobi. Unless they have converged, the basis is compressed to
+        * the best Ritz vectors plus the residual direction and extended again (Krylov-Schur). The
+        * residual of a Ritz pair is beta times the last entry of its Ritz vector, so convergence
+        * checks cost no extra products.
+        *
+        * Example usage:
+        * \code
+        * NumeriCore::Matrix::SpectralConfig config;
+        * config.tolerance = 1e-6;
+        * auto pca = NumeriCore::Matrix::lanczos(covariance, 5, config);  // leading 5 components
+        * \endcode
+        *
+        * @param a Operator computing y = A * x, as for the Krylov solvers.
+        * @param n Order of A.
+        * @param k Number of eigenpairs.
+        * @param config Tolerance, budget, subspace size, wanted end of the spectrum and seed.
+        * @throw std::invalid_argument If k is 0 or larger than n.
+        * @tparam T Type of vector elements (floating point).
+        */
+
+        template<class T, class Operator>
+        EigenResult<T> lanczos(const Operator& a, size_t n, size_t k, const SpectralConfig& config = SpectralConfig())
+        {
+            detail::checkRank(k, n);
+            const size_t m = std::min(n, config.subspace ? std::max(config.subspace, k + 1) : std::max<size_t>(2 * k + 1, 20));
+            std::mt19937 gen(config.seed);
+            const T eps = std::numeric_limits<T>::epsilon();
+
+            std::vector<std::vector<T>> basis(m + 1, std::vector<T>(n));
+            std::vector<T> h(m * m, static_cast<T>(0));
+            std::vector<T> w(n);
+            T scale = static_cast<T>(0);
+
+            // Random unit vector orthogonal to the first count basis vectors.
+            auto freshDirection = [&](size_t count, std::vector<T>& v) {
+                v = detail::gaussianBlock<T>(n, 1, gen);
+                for (size_t pass = 0; pass < 2; ++pass) {
+                    for (size_t i = 0; i < count; ++i) {
+                        detail::axpy(-detail::dot(basis[i], v), basis[i], v);
+                    }
+                }
+                const T norm = static_cast<T>(detail::norm2(v));
+                for (auto& value : v) {
+                    value /= norm;
+                }
+            };
+
+            EigenResult<T> result;
+            freshDirection(0, basis[0]);
+            size_t j = 0;
+            T beta = static_cast<T>(0);
+
+            while (true) {
+                for (; j < m && result.iterations < config.maxIterations; ++j) {
+                    a(basis[j], w);
+                    ++result.iterations;
+                    std::vector<T> coefficients(j + 1, static_cast<T>(0));
+                    for (size_t pass = 0; pass < 2; ++pass) {
+                        for (size_t i = 0; i <= j; ++i) {
+                            const T c = detail::dot(basis[i], w);
+                            coefficients[i] += c;
+                            detail::axpy(-c, basis[i], w);
+                        }
+                    }
+                    for (size_t i = 0; i <= j; ++i) {
+                        h[i * m + j] = h[j * m + i] = coefficients[i];
+                        scale = std::max(scale, std::abs(coefficients[i]));
+                    }
+                    beta = static_cast<T>(detail::norm2(w));
+                    scale = std::max(scale, beta);
+                    if (beta <= 100 * eps * scale) {
+                        // Invariant subspace found, continue in a fresh direction without coupling.
+                        beta = static_cast<T>(0);
+                        if (j + 1 < n) {
+                            freshDirection(j + 1, basis[j + 1]);
+                        }
+                    }
+                    else {
+                        for (size_t r = 0; r < n; ++r) {
+                            basis[j + 1][r] = w[r] / beta;
+                        }
+                    }
+                    if (j + 1 < m) {
+                        h[(j + 1) * m + j] = h[j * m + j + 1] = beta;
+                    }
+                }
+
+                // Rayleigh-Ritz on the j x j projected matrix.
+                std::vector<T> projected(j * j);
+                for (size_t r = 0; r < j; ++r) {
+                    std::copy(h.begin() + r * m, h.begin() + r * m + j, projected.begin() + r * j);
+                }
+                std::vector<T> s;
+                const std::vector<T> theta = detail::symmetricEigen(projected, j, s);
+                const std::vector<size_t> order = detail::spectrumOrder(theta, config.target);
+
+                const size_t wanted = std::min(k, j);
+                result.residuals.assign(wanted, 0.0);
+                bool converged = wanted == k;
+                for (size_t i = 0; i < wanted; ++i) {
+                    const double residual = static_cast<double>(beta * std::abs(s[(j - 1) * j + order[i]]));
+                    result.residuals[i] = residual / std::max(static_cast<double>(std::abs(theta[order[i]])), static_cast<double>(eps * scale));
+                    converged = converged && result.residuals[i] <= config.tolerance;
+                }
+
+                const bool finished = converged || result.iterations >= config.maxIterations || j == n;
+                const size_t keep = finished ? wanted : std::min(m - 1, k + (m - k) / 2);
+
+                // Ritz vectors V * S(:, order[i]), row-parallel.
+                std::vector<std::vector<T>> ritz(keep, std::vector<T>(n));
+                detail::parallelFor(0, n, detail::kParallelGrainRows * 16, [&](size_t lo, size_t hi) {
+                    for (size_t i = 0; i < keep; ++i) {
+                        T* out = ritz[i].data();
+                        for (size_t r = lo; r < hi; ++r) {
+                            out[r] = static_cast<T>(0);
+                        }
+                        for (size_t l = 0; l < j; ++l) {
+                            const T coefficient = s[l * j + order[i]];
+                            const T* v = basis[l].data();
+                            for (size_t r = lo; r < hi; ++r) {
+                                out[r] += coefficient * v[r];
+                            }
+                        }
+                    }
+                });
+
+                if (finished) {
+                    result.converged = converged || (j == n && wanted == k);
+                    result.values.resize(wanted);
+                    result.vectors = Matrix<T>(n, wanted, zeroFill);
+                    for (size_t i = 0; i < wanted; ++i) {
+                        result.values[i] = theta[order[i]];
+                        for (size_t r = 0; r < n; ++r) {
+                            result.vectors.rowData(r)[i] = ritz[i][r];
+                        }
+                    }
+                    return result;
+                }
+
+                // Thick restart: A V' = V' diag(theta) + beta * v_j * s_last^T.
+                std::fill(h.begin(), h.end(), static_cast<T>(0));
+                std::vector<T> residualDirection = std::move(basis[j]);
+                for (size_t i = 0; i < keep; ++i) {
+                    basis[i] = std::move(ritz[i]);
+                    h[i * m + i] = theta[order[i]];
+                    h[keep * m + i] = h[i * m + keep] = beta * s[(j - 1) * j + order[i]];
+                }
+                basis[keep] = std::move(residualDirection);
+                for (size_t i = keep + 1; i <= m; ++i) {
+                    basis[i].assign(n, static_cast<T>(0));
+                }
+                j = keep;
+            }
+        }
+
+        /**
+        * @brief lanczos() on a dense symmetric matrix.
+        * @throw std::invalid_argument If a is not symmetric or k is out of range.
+        */
+
+        template<class T>
+        EigenResult<T> lanczos(const Matrix<T>& a, size_t k, const SpectralConfig& config = SpectralConfig())
+        {
+            detail::checkSymmetric(a);
+            return lanczos<T>(DenseOperator<T>(a), a.getRows(), k, config);
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Block power iteration
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief k eigenpairs of largest magnitude of a symmetric operator by block power iteration.
+        * Keeps k + oversampling orthonormal columns X. Each iteration forms Z = A X in one block
+        * product, projects H = X^T Z and rotates both X and Z to the Ritz vectors of H. The next
+        * block is an orthonormal basis of Z. The extra columns speed convergence of the k-th pair
+        * from |lambda_k+1 / lambda_k| to |lambda_k+b / lambda_k|.
+        *
+        * @param a Block operator computing y = A * x for an n x b matrix x into y, see columnwise().
+        * @param n Order of A.
+        * @param k Number of eigenpairs.
+        * @param config Tolerance, budget of block products, oversampling and seed.
+        * @throw std::invalid_argument If k is 0 or larger than n.
+        * @tparam T Type of matrix elements (floating point).
+        */
+
+        template<class T, class BlockOperator>
+        EigenResult<T> blockPowerIteration(const BlockOperator& a, size_t n, size_t k, const SpectralConfig& config = SpectralConfig())
+        {
+            detail::checkRank(k, n);
+            const size_t b = std::min(n, k + config.oversampling);
+            std::mt19937 gen(config.seed);
+            const T eps = std::numeric_limits<T>::epsilon();
+
+            std::vector<T> x = detail::gaussianBlock<T>(n, b, gen);
+            detail::orthonormalize(x, n, b);
+            Matrix<T> in(n, b, zeroFill);
+            Matrix<T> out(n, b, zeroFill);
+
+            EigenResult<T> result;
+            while (true) {
+                const std::vector<T> z = detail::applyBlock(a, x, in, out);
+                ++result.iterations;
+
+                std::vector<T> h = detail::multiplyTransposed(x, z, n, b, b);
+                for (size_t i = 0; i < b; ++i) {
+                    for (size_t l = 0; l < i; ++l) {
+                        h[i * b + l] = h[l * b + i] = (h[i * b + l] + h[l * b + i]) / 2;
+                    }
+                }
+                std::vector<T> s;
+                const std::vector<T> theta = detail::symmetricEigen(h, b, s);
+                const std::vector<size_t> order = detail::spectrumOrder(theta, Spectrum::LargestMagnitude);
+                std::vector<T> rotation(b * b);
+                for (size_t l = 0; l < b; ++l) {
+                    for (size_t i = 0; i < b; ++i) {
+                        rotation[l * b + i] = s[l * b + order[i]];
+                    }
+                }
+                const std::vector<T> ritz = detail::multiply(x, rotation, n, b, b);
+                std::vector<T> image = detail::multiply(z, rotation, n, b, b);
+
+                result.residuals.assign(k, 0.0);
+                bool converged = true;
+                T top = std::abs(theta[order[0]]);
+                for (size_t i = 0; i < k; ++i) {
+                    const T value = theta[order[i]];
+                    T residual = static_cast<T>(0);
+                    for (size_t r = 0; r < n; ++r) {
+                        const T d = image[r * b + i] - value * ritz[r * b + i];
+                        residual += d * d;
+                    }
+                    result.residuals[i] = std::sqrt(static_cast<double>(residual)) / std::max(static_cast<double>(std::abs(value)), static_cast<double>(eps * top));
+                    converged = converged && result.residuals[i] <= config.tolerance;
+                }
+
+                if (converged || result.iterations >= config.maxIterations) {
+                    result.converged = converged;
+                    result.values.resize(k);
+                    result.vectors = Matrix<T>(n, k, zeroFill);
+                    for (size_t i = 0; i < k; ++i) {
+                        result.values[i] = theta[order[i]];
+                        for (size_t r = 0; r < n; ++r) {
+                            result.vectors.rowData(r)[i] = ritz[r * b + i];
+                        }
+                    }
+                    return result;
+                }
+
+                detail::orthonormalize(image, n, b);
+                x = std::move(image);
+            }
+        }
+
+        /**
+        * @brief blockPowerIteration() on a dense symmetric matrix, the block products are GEMMs.
+        * @throw std::invalid_argument If a is not symmetric or k is out of range.
+        */
+
+        template<class T>
+        EigenResult<T> blockPowerIteration(const Matrix<T>& a, size_t k, const SpectralConfig& config = SpectralConfig())
+        {
+            detail::checkSymmetric(a);
+            const detail::DenseBlockOperator<T> op{ detail::pack(a), a.getRows(), a.getCols() };
+            return blockPowerIteration<T>(op, a.getRows(), k, config);
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Randomized SVD
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief k leading singular triplets of an m x n operator by randomized subspace iteration
+        * (Halko, Martinsson and Tropp).
+        * A Gaussian sketch Y = A * Omega with l = k + oversampling columns is orthonormalized to
+        * Q, B^T = A^T * Q is reduced by one-sided Jacobi to B^T = V * Sigma * W^T, and
+        * A ~ (Q W) Sigma V^T. Each further pass is a power step Y = A * V on A A^T. Passes stop
+        * once the k singular values change by less than config.tolerance relative, so
+        * tolerance trades accuracy for passes.
+        *
+        * @param a Block operator computing y = A * x for an n x l matrix x.
+        * @param at Block operator computing y = A^T * x for an m x l matrix x.
+        * @param m Rows of A.
+        * @param n Columns of A.
+        * @param k Number of singular triplets.
+        * @param config Tolerance, budget of block products, oversampling and seed.
+        * @throw std::invalid_argument If k is 0 or larger than min(m, n).
+        * @tparam T Type of matrix elements (floating point).
+        */
+
+        template<class T, class Operator, class AdjointOperator>
+        SvdResult<T> randomizedSvd(const Operator& a, const AdjointOperator& at, size_t m, size_t n, size_t k, const SpectralConfig& config = SpectralConfig())
+        {
+            detail::checkRank(k, std::min(m, n));
+            const size_t l = std::min(std::min(m, n), k + config.oversampling);
+            std::mt19937 gen(config.seed);
+
+            Matrix<T> rightIn(n, l, zeroFill);
+            Matrix<T> leftOut(m, l, zeroFill);
+            Matrix<T> leftIn(m, l, zeroFill);
+            Matrix<T> rightOut(n, l, zeroFill);
+
+            SvdResult<T> result;
+            std::vector<T> y = detail::applyBlock(a, detail::gaussianBlock<T>(n, l, gen), rightIn, leftOut);
+            ++result.iterations;
+            std::vector<T> previous;
+
+            while (true) {
+                detail::orthonormalize(y, m, l);
+                std::vector<T> bt = detail::applyBlock(at, y, leftIn, rightOut);
+                ++result.iterations;
+                std::vector<T> w;
+                const std::vector<T> sigma = detail::jacobiSvd(bt, n, l, w);
+
+                bool converged = !previous.empty();
+                result.residuals.assign(k, 1.0);
+                if (!previous.empty()) {
+                    for (size_t i = 0; i < k; ++i) {
+                        const T change = std::abs(sigma[i] - previous[i]);
+                        result.residuals[i] = sigma[i] > 0 ? static_cast<double>(change / sigma[i]) : 0.0;
+                        converged = converged && result.residuals[i] <= config.tolerance;
+                    }
+                }
+
+                if (converged || result.iterations + 2 > config.maxIterations) {
+                    const std::vector<T> u = detail::multiply(y, w, m, l, l);
+                    result.converged = converged;
+                    result.values.assign(sigma.begin(), sigma.begin() + k);
+                    result.u = Matrix<T>(m, k, zeroFill);
+                    result.v = Matrix<T>(n, k, zeroFill);
+                    for (size_t r = 0; r < m; ++r) {
+                        std::copy(u.begin() + r * l, u.begin() + r * l + k, result.u.rowData(r));
+                    }
+                    for (size_t r = 0; r < n; ++r) {
+                        std::copy(bt.begin() + r * l, bt.begin() + r * l + k, result.v.rowData(r));
+                    }
+                    return result;
+                }
+
+                previous = sigma;
+                y = detail::applyBlock(a, bt, rightIn, leftOut);
+                ++result.iterations;
+            }
+        }
+
+        /**
+        * @brief randomizedSvd() on a dense matrix, the products with A and A^T are GEMMs.
+        * @throw std::invalid_argument If k is 0 or larger than min(rows, cols).
+        */
+
+        template<class T>
+        SvdResult<T> randomizedSvd(const Matrix<T>& a, size_t k, const SpectralConfig& config = SpectralConfig())
+        {
+            const size_t m = a.getRows();
+            const size_t n = a.getCols();
+            const std::vector<T> packed = detail::pack(a);
+            std::vector<T> transposed(n * m);
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    transposed[j * m + i] = packed[i * n + j];
+                }
+            }
+            const detail::DenseBlockOperator<T> op{ packed, m, n };
+            const detail::DenseBlockOperator<T> adjointOp{ std::move(transposed), n, m };
+            return randomizedSvd<T>(op, adjointOp, m, n, k, config);
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __SPECTRAL_HPP__ */
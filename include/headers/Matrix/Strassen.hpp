@@ -0,0 +1,362 @@
+#ifndef __STRASSEN_HPP__
+#define __STRASSEN_HPP__
+
+#include <vector>
+#include <future>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Tuning knobs for the Strassen-Winograd product.
+         *
+         * crossover          : sub-problems of this size or smaller use the classic blocked kernel.
+         * parallelDepth      : number of recursion levels whose seven sub-products run concurrently.
+         * maxWorkspaceBytes  : upper bound for temporary storage, 0 means unbounded. If the estimate
+         *                      exceeds it the parallel depth is reduced, and finally the classic kernel is used.
+         * maxRelativeBound   : upper bound for the a-priori error bound relative to ||A|| * ||B||,
+         *                      0 means unbounded. If exceeded the classic kernel is used.
+         */
+        struct StrassenConfig
+        {
+            size_t crossover = 128;
+            size_t parallelDepth = 1;
+            size_t maxWorkspaceBytes = 0;
+            double maxRelativeBound = 0.0;
+        };
+
+
+        /**
+         * @brief Describes the recursion a Strassen-Winograd product will run and its accuracy.
+         *
+         * The bounds are Higham's normwise bounds in the max-norm (Accuracy and Stability of
+         * Numerical Algorithms, ch. 23), to first order in the unit roundoff u:
+         *      classic  : n^2 u ||A|| ||B||
+         *      winograd : [ (n/n0)^log2(18) (n0^2 + 6 n0) - 6n ] u ||A|| ||B||
+         * with n the padded size and n0 the leaf size.
+         */
+        struct StrassenReport
+        {
+            size_t levels = 0;          // recursion levels above the classic kernel
+            size_t paddedSize = 0;      // size after zero padding to leafSize * 2^levels
+            size_t leafSize = 0;        // size handed to the classic kernel
+            size_t parallelDepth = 0;   // levels that actually run in parallel
+            size_t workspaceBytes = 0;  // peak temporary storage, packed operands included
+            double unitRoundoff = 0.0;
+            double normA = 0.0;         // max |a_ij|
+            double normB = 0.0;         // max |b_ij|
+            double classicBound = 0.0;  // absolute error bound of the classic kernel
+            double strassenBound = 0.0; // absolute error bound of the fast product
+            double relativeBound = 0.0; // strassenBound / (||A|| ||B||)
+            bool useStrassen = false;   // false if the call falls back to the classic kernel
+        };
+
+
+        namespace detail
+        {
+            // ////////////////////////////////////////////////////////////////////////////////////////
+            // Strassen-Winograd helpers
+            // ////////////////////////////////////////////////////////////////////////////////////////
+
+            template<class T>
+            inline void addBlock(size_t n, const T* X, size_t ldx, const T* Y, size_t ldy, T* Z, size_t ldz)
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    for (size_t j = 0; j < n; ++j) {
+                        Z[i * ldz + j] = X[i * ldx + j] + Y[i * ldy + j];
+                    }
+                }
+            }
+
+            template<class T>
+            inline void subBlock(size_t n, const T* X, size_t ldx, const T* Y, size_t ldy, T* Z, size_t ldz)
+            {
+                for (size_t i = 0; i < n; ++i) {
+                    for (size_t j = 0; j < n; ++j) {
+                        Z[i * ldz + j] = X[i * ldx + j] - Y[i * ldy + j];
+                    }
+                }
+            }
+
+
+            /**
+            * @brief Temporary elements needed by one recursion of size n and everything below it.
+            * Every level holds 8 operand sums and 7 products of size (n/2)^2, parallel levels keep
+            * the workspace of all seven children alive at once.
+            */
+
+            inline size_t winogradWorkspace(size_t n, size_t crossover, size_t parallelDepth, size_t depth = 0)
+            {
+                if (n <= crossover || n % 2 != 0) {
+                    return 0;
+                }
+                const size_t h = n / 2;
+                const size_t children = depth < parallelDepth ? 7 : 1;
+                return 15 * h * h + children * winogradWorkspace(h, crossover, parallelDepth, depth + 1);
+            }
+
+
+            /**
+            * @brief Recursive Strassen-Winograd product C = A * B of n x n row-major views.
+            * Uses 7 multiplications and 15 additions per level.
+            */
+
+            template<class T>
+            inline void winograd(size_t n,
+                                 const T* A, size_t lda,
+                                 const T* B, size_t ldb,
+                                 T* C, size_t ldc,
+                                 size_t crossover, size_t parallelDepth, size_t depth = 0)
+            {
+                if (n <= crossover || n % 2 != 0) {
+                    gemm(n, n, n, A, lda, B, ldb, C, ldc);
+                    return;
+                }
+
+                const size_t h = n / 2;
+                const size_t hh = h * h;
+
+                const T* A11 = A;           const T* A12 = A + h;
+                const T* A21 = A + h * lda; const T* A22 = A + h * lda + h;
+                const T* B11 = B;           const T* B12 = B + h;
+                const T* B21 = B + h * ldb; const T* B22 = B + h * ldb + h;
+                T* C11 = C;                 T* C12 = C + h;
+                T* C21 = C + h * ldc;       T* C22 = C + h * ldc + h;
+
+                std::vector<T> workspace(15 * hh);
+                T* S1 = workspace.data();
+                T* S2 = S1 + hh; T* S3 = S2 + hh; T* S4 = S3 + hh;
+                T* T1 = S4 + hh; T* T2 = T1 + hh; T* T3 = T2 + hh; T* T4 = T3 + hh;
+                T* P[7];
+                P[0] = T4 + hh;
+                for (size_t p = 1; p < 7; ++p) {
+                    P[p] = P[p - 1] + hh;
+                }
+
+                addBlock(h, A21, lda, A22, lda, S1, h); // S1 = A21 + A22
+                subBlock(h, S1, h, A11, lda, S2, h);    // S2 = S1 - A11
+                subBlock(h, A11, lda, A21, lda, S3, h); // S3 = A11 - A21
+                subBlock(h, A12, lda, S2, h, S4, h);    // S4 = A12 - S2
+                subBlock(h, B12, ldb, B11, ldb, T1, h); // T1 = B12 - B11
+                subBlock(h, B22, ldb, T1, h, T2, h);    // T2 = B22 - T1
+                subBlock(h, B22, ldb, B12, ldb, T3, h); // T3 = B22 - B12
+                subBlock(h, T2, h, B21, ldb, T4, h);    // T4 = T2 - B21
+
+                struct Product { const T* x; size_t ldx; const T* y; size_t ldy; };
+                const Product products[7] = {
+                    { A11, lda, B11, ldb }, // P1 = A11 * B11
+                    { A12, lda, B21, ldb }, // P2 = A12 * B21
+                    { S4,  h,   B22, ldb }, // P3 = S4 * B22
+                    { A22, lda, T4,  h   }, // P4 = A22 * T4
+                    { S1,  h,   T1,  h   }, // P5 = S1 * T1
+                    { S2,  h,   T2,  h   }, // P6 = S2 * T2
+                    { S3,  h,   T3,  h   }  // P7 = S3 * T3
+                };
+
+                if (depth < parallelDepth) {
+                    std::vector<std::future<void>> pending;
+                    pending.reserve(6);
+                    for (size_t p = 1; p < 7; ++p) {
+                        pending.push_back(std::async(std::launch::async, [&, p]() {
+                            winograd(h, products[p].x, products[p].ldx, products[p].y, products[p].ldy,
+                                     P[p], h, crossover, parallelDepth, depth + 1);
+                        }));
+                    }
+                    winograd(h, products[0].x, products[0].ldx, products[0].y, products[0].ldy,
+                             P[0], h, crossover, parallelDepth, depth + 1);
+                    for (auto& task : pending) {
+                        task.get();
+                    }
+                } else {
+                    for (size_t p = 0; p < 7; ++p) {
+                        winograd(h, products[p].x, products[p].ldx, products[p].y, products[p].ldy,
+                                 P[p], h, crossover, parallelDepth, depth + 1);
+                    }
+                }
+
+                // U2 = P1 + P6 is kept in P6, U3 = U2 + P7 in P7, U4 = U2 + P5 in P5
+                addBlock(h, P[0], h, P[1], h, C11, ldc);  // C11 = P1 + P2
+                addBlock(h, P[0], h, P[5], h, P[5], h);   // U2
+                addBlock(h, P[5], h, P[6], h, P[6], h);   // U3
+                addBlock(h, P[5], h, P[4], h, P[5], h);   // U4
+                addBlock(h, P[5], h, P[2], h, C12, ldc);  // C12 = U4 + P3
+                subBlock(h, P[6], h, P[3], h, C21, ldc);  // C21 = U3 - P4
+                addBlock(h, P[6], h, P[4], h, C22, ldc);  // C22 = U3 + P5
+            }
+
+
+            template<class T>
+            inline double maxAbs(const Matrix<T>& m)
+            {
+                double result = 0.0;
+                for (size_t i = 0; i < m.getRows(); ++i) {
+                    for (size_t j = 0; j < m.getCols(); ++j) {
+                        result = std::max(result, static_cast<double>(std::abs(m.getElement(i, j))));
+                    }
+                }
+                return result;
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Strassen-Winograd product
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Plans a Strassen-Winograd product and reports its workspace and accuracy bound.
+        * Nothing is multiplied, the report can be inspected to decide per call site whether the
+        * fast product is acceptable.
+        *
+        * @param m1 The first matrix.
+        * @param m2 The second matrix.
+        * @param config Tuning knobs of the recursion.
+        * @throws std::invalid_argument if matrices have incompatible dimensions.
+        * @return The plan and its a-priori error bounds.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline StrassenReport strassenReport(const Matrix<T>& m1, const Matrix<T>& m2, const StrassenConfig& config = StrassenConfig())
+        {
+            if (m1.getCols() != m2.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+
+            StrassenReport report;
+            const size_t n = m1.getRows();
+            const size_t crossover = std::max<size_t>(config.crossover, 1);
+            const bool square = n == m1.getCols() && n == m2.getCols();
+
+            report.unitRoundoff = static_cast<double>(std::numeric_limits<T>::epsilon()) / 2.0;
+            report.normA = detail::maxAbs(m1);
+            report.normB = detail::maxAbs(m2);
+
+            size_t leaf = n;
+            while (square && leaf > crossover) {
+                leaf = (leaf + 1) / 2;
+                report.levels++;
+            }
+            report.leafSize = leaf;
+            report.paddedSize = leaf << report.levels;
+
+            const double np = static_cast<double>(report.paddedSize);
+            const double n0 = static_cast<double>(leaf);
+            const double scale = report.unitRoundoff * report.normA * report.normB;
+            const double inner = static_cast<double>(m1.getCols());
+            report.classicBound = inner * inner * scale;
+            report.strassenBound = (std::pow(np / n0, std::log2(18.0)) * (n0 * n0 + 6.0 * n0) - 6.0 * np) * scale;
+            report.relativeBound = report.normA * report.normB > 0.0
+                ? report.strassenBound / (report.normA * report.normB)
+                : 0.0;
+
+            report.useStrassen = report.levels > 0;
+            if (config.maxRelativeBound > 0.0 && report.relativeBound > config.maxRelativeBound) {
+                report.useStrassen = false;
+            }
+
+            if (report.useStrassen) {
+                const size_t hardwareThreads = std::thread::hardware_concurrency();
+                size_t depth = hardwareThreads > 1 ? std::min(config.parallelDepth, report.levels) : 0;
+                const size_t operands = 3 * report.paddedSize * report.paddedSize;
+
+                auto bytesFor = [&](size_t parallelDepth) {
+                    return (operands + detail::winogradWorkspace(report.paddedSize, leaf, parallelDepth)) * sizeof(T);
+                };
+
+                report.workspaceBytes = bytesFor(depth);
+                while (config.maxWorkspaceBytes != 0 && report.workspaceBytes > config.maxWorkspaceBytes && depth > 0) {
+                    report.workspaceBytes = bytesFor(--depth);
+                }
+                if (config.maxWorkspaceBytes != 0 && report.workspaceBytes > config.maxWorkspaceBytes) {
+                    report.useStrassen = false;
+                }
+                report.parallelDepth = depth;
+            }
+
+            if (!report.useStrassen) {
+                report.levels = 0;
+                report.parallelDepth = 0;
+                report.workspaceBytes = 0;
+                report.leafSize = n;
+                report.paddedSize = n;
+                report.strassenBound = report.classicBound;
+                report.relativeBound = report.normA * report.normB > 0.0
+                    ? report.classicBound / (report.normA * report.normB)
+                    : 0.0;
+            }
+            return report;
+        }
+
+
+        /**
+        * @brief Multiplies two matrices with the Strassen-Winograd recursion.
+        * Square operands are zero padded to leafSize * 2^levels, recursed on until the sub-problems
+        * reach the crossover and then finished by the classic blocked kernel. Non-square operands,
+        * operands below the crossover and plans rejected by the workspace or accuracy limits use the
+        * classic kernel, detail::gemm() over row bands of the packed operands.
+        *
+        * Example usage:
+        * \code
+        * NumeriCore::Matrix::StrassenConfig config;
+        * config.crossover = 256;
+        * NumeriCore::Matrix::StrassenReport report;
+        * auto C = NumeriCore::Matrix::strassenMultiply(A, B, config, &report);
+        * \endcode
+        *
+        * @param m1 The first matrix.
+        * @param m2 The second matrix.
+        * @param config Tuning knobs of the recursion.
+        * @param report If not null receives the plan that was executed.
+        * @throws std::invalid_argument if matrices have incompatible dimensions.
+        * @return Resultant matrix of the multiplication.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline Matrix<T> strassenMultiply(const Matrix<T>& m1, const Matrix<T>& m2,
+                                          const StrassenConfig& config = StrassenConfig(),
+                                          StrassenReport* report = nullptr)
+        {
+            const StrassenReport plan = strassenReport(m1, m2, config);
+            if (report != nullptr) {
+                *report = plan;
+            }
+            Matrix<T> result(m1.getRows(), m2.getCols(), zeroFill);
+            if (!plan.useStrassen) {
+                const size_t m = m1.getRows();
+                const size_t k = m1.getCols();
+                const size_t n = m2.getCols();
+                const std::vector<T> a = detail::pack(m1);
+                const std::vector<T> b = detail::pack(m2);
+                std::vector<T> c(m * n);
+                detail::parallelFor(0, m, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                    detail::gemm(hi - lo, n, k, a.data() + lo * k, k, b.data(), n, c.data() + lo * n, n);
+                });
+                detail::unpack(c.data(), n, result);
+                return result;
+            }
+
+            const size_t np = plan.paddedSize;
+
+            std::vector<T> a = detail::pack(m1, np, np);
+            std::vector<T> b = detail::pack(m2, np, np);
+            std::vector<T> c(np * np);
+            detail::winograd(np, a.data(), np, b.data(), np, c.data(), np, plan.leafSize, plan.parallelDepth);
+            detail::unpack(c.data(), np, result);
+            return result;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __STRASSEN_HPP__ */
@@ -0,0 +1,535 @@
+#ifndef __STREAMING_HPP__
+#define __STREAMING_HPP__
+
+// Row-block streaming is built on C++20 coroutines, with an older standard this header is empty.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <utility>
+#include <fstream>
+#include <istream>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <exception>
+#include <coroutine>
+#include <stdexcept>
+#include <type_traits>
+#include <condition_variable>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "Matrix.hpp"
+#include "Reductions.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Consecutive rows of a streamed matrix, row-major in one buffer.
+         * Blocks are moved from stage to stage, so a pipeline holds only the blocks in flight.
+         */
+        template<class T>
+        struct RowBlock
+        {
+            size_t firstRow = 0; // index of the first row in the whole stream
+            size_t rows = 0;
+            size_t cols = 0;
+            std::vector<T> values;
+
+            T* row(size_t i) { return values.data() + i * cols; }
+            const T* row(size_t i) const { return values.data() + i * cols; }
+        };
+
+
+        /**
+         * @brief Lazy sequence produced by a coroutine with co_yield.
+         * Nothing runs until the first element is requested, each increment resumes the coroutine
+         * up to its next co_yield. An exception thrown in the coroutine is rethrown to the
+         * consumer. Move-only, destroying it destroys the coroutine.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::Generator<RowBlock<double>> ramp(size_t blocks)
+         * {
+         *     for (size_t b = 0; b < blocks; ++b) {
+         *         RowBlock<double> block{ b, 1, 3, { 1.0 * b, 2.0 * b, 3.0 * b } };
+         *         co_yield std::move(block);
+         *     }
+         * }
+         * \endcode
+         */
+        template<class V>
+        class Generator
+        {
+        public:
+            struct promise_type
+            {
+                std::optional<V> current;
+                std::exception_ptr error;
+
+                Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+                std::suspend_always initial_suspend() noexcept { return {}; }
+                std::suspend_always final_suspend() noexcept { return {}; }
+                std::suspend_always yield_value(V value)
+                {
+                    current = std::move(value);
+                    return {};
+                }
+                void return_void() {}
+                void unhandled_exception() { error = std::current_exception(); }
+            };
+
+            class iterator
+            {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = V;
+                using difference_type = std::ptrdiff_t;
+
+                explicit iterator(Generator* generator) : m_generator(generator) {}
+
+                V& operator*() const { return *m_generator->m_handle.promise().current; }
+                iterator& operator++()
+                {
+                    m_generator->advance();
+                    return *this;
+                }
+                void operator++(int) { ++*this; }
+                friend bool operator==(const iterator& it, std::default_sentinel_t) { return it.atEnd(); }
+
+            private:
+                bool atEnd() const { return m_generator->done(); }
+
+            private:
+                Generator* m_generator;
+            };
+
+            Generator() = default;
+            Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+            Generator& operator=(Generator&& other) noexcept
+            {
+                std::swap(m_handle, other.m_handle);
+                return *this;
+            }
+            Generator(const Generator&) = delete;
+            Generator& operator=(const Generator&) = delete;
+
+            ~Generator()
+            {
+                if (m_handle) {
+                    m_handle.destroy();
+                }
+            }
+
+            iterator begin()
+            {
+                advance();
+                return iterator(this);
+            }
+            std::default_sentinel_t end() const { return {}; }
+
+        private:
+            explicit Generator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+            void advance()
+            {
+                m_handle.promise().current.reset();
+                m_handle.resume();
+                if (m_handle.promise().error) {
+                    std::rethrow_exception(std::exchange(m_handle.promise().error, nullptr));
+                }
+            }
+
+            bool done() const { return !m_handle || m_handle.done(); }
+
+        private:
+            std::coroutine_handle<promise_type> m_handle = nullptr;
+        };
+
+        template<class T>
+        using RowStream = Generator<RowBlock<T>>;
+
+
+        namespace detail
+        {
+            /**
+            * @brief Bounded hand-off between a producer thread and a consuming coroutine.
+            * push() blocks while capacity blocks are waiting, which is the backpressure that keeps a
+            * fast producer from running ahead of its consumer.
+            */
+
+            template<class T>
+            class BlockQueue
+            {
+            public:
+                explicit BlockQueue(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+                bool push(RowBlock<T>&& block) // false once the consumer has gone away
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_notFull.wait(lock, [this]() { return m_cancelled || m_blocks.size() < m_capacity; });
+                    if (m_cancelled) {
+                        return false;
+                    }
+                    m_blocks.push_back(std::move(block));
+                    m_notEmpty.notify_one();
+                    return true;
+                }
+
+                std::optional<RowBlock<T>> pop() // empty once the producer has finished
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_notEmpty.wait(lock, [this]() { return m_closed || !m_blocks.empty(); });
+                    if (m_blocks.empty()) {
+                        if (m_error) {
+                            std::rethrow_exception(m_error);
+                        }
+                        return std::nullopt;
+                    }
+                    RowBlock<T> block = std::move(m_blocks.front());
+                    m_blocks.pop_front();
+                    m_notFull.notify_one();
+                    return block;
+                }
+
+                void close(std::exception_ptr error = nullptr)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_closed = true;
+                    m_error = error;
+                    m_notEmpty.notify_all();
+                }
+
+                void cancel()
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_cancelled = true;
+                    m_notFull.notify_all();
+                }
+
+            private:
+                std::mutex m_mutex;
+                std::condition_variable m_notEmpty;
+                std::condition_variable m_notFull;
+                std::deque<RowBlock<T>> m_blocks;
+                size_t m_capacity;
+                bool m_closed = false;
+                bool m_cancelled = false;
+                std::exception_ptr m_error;
+            };
+
+            // Stops and joins the producer when the consuming coroutine ends or is destroyed early.
+            template<class T>
+            struct ProducerGuard
+            {
+                BlockQueue<T>& queue;
+                std::thread& producer;
+
+                ~ProducerGuard()
+                {
+                    queue.cancel();
+                    if (producer.joinable()) {
+                        producer.join();
+                    }
+                }
+            };
+
+            template<class T>
+            RowBlock<T> emptyBlock(size_t firstRow, size_t rows, size_t cols)
+            {
+                return RowBlock<T>{ firstRow, rows, cols, std::vector<T>(rows * cols) };
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Row block sources
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Streams a matrix in blocks of blockRows rows, the last block may be shorter.
+        * The matrix must outlive the stream.
+        * @throws std::invalid_argument if blockRows is 0 (on the first request).
+        */
+
+        template<class T>
+        RowStream<T> blocksOf(const Matrix<T>& m, size_t blockRows)
+        {
+            if (blockRows == 0) {
+                throw std::invalid_argument("Blocks must have at least one row!");
+            }
+            for (size_t first = 0; first < m.getRows(); first += blockRows) {
+                const size_t rows = std::min(blockRows, m.getRows() - first);
+                RowBlock<T> block = detail::emptyBlock<T>(first, rows, m.getCols());
+                for (size_t i = 0; i < rows; ++i) {
+                    std::copy(m.rowData(first + i), m.rowData(first + i) + m.getCols(), block.row(i));
+                }
+                co_yield std::move(block);
+            }
+        }
+
+        /**
+        * @brief Parses whitespace separated values, cols per row, into blocks of blockRows rows.
+        * Only one block is held in memory. The stream must outlive the generator.
+        * @throws std::invalid_argument if cols or blockRows is 0.
+        * @throws std::runtime_error if the input ends inside a row or holds a malformed value.
+        */
+
+        template<class T>
+        RowStream<T> readBlocks(std::istream& in, size_t cols, size_t blockRows)
+        {
+            if (cols == 0 || blockRows == 0) {
+                throw std::invalid_argument("Blocks must have at least one row and one column!");
+            }
+            for (size_t first = 0;; first += blockRows) {
+                RowBlock<T> block = detail::emptyBlock<T>(first, blockRows, cols);
+                size_t rows = 0;
+                for (; rows < blockRows; ++rows) {
+                    T* row = block.row(rows);
+                    if (!(in >> row[0])) {
+                        if (!in.eof()) {
+                            throw std::runtime_error("Malformed value in matrix stream.");
+                        }
+                        break;
+                    }
+                    for (size_t j = 1; j < cols; ++j) {
+                        if (!(in >> row[j])) {
+                            throw std::runtime_error("Matrix stream ended inside a row.");
+                        }
+                    }
+                }
+                if (rows == 0) {
+                    co_return;
+                }
+                block.rows = rows;
+                block.values.resize(rows * cols);
+                co_yield std::move(block);
+                if (rows < blockRows) {
+                    co_return;
+                }
+            }
+        }
+
+        /**
+        * @brief readBlocks() on a text file, which is opened on the first request.
+        * @throws std::runtime_error if the file cannot be opened.
+        */
+
+        template<class T>
+        RowStream<T> readBlocks(std::string path, size_t cols, size_t blockRows)
+        {
+            std::ifstream file(path);
+            if (!file) {
+                throw std::runtime_error("Cannot open matrix file " + path + ".");
+            }
+            for (auto& block : readBlocks<T>(file, cols, blockRows)) {
+                co_yield std::move(block);
+            }
+        }
+
+#ifdef __unix__
+
+        /**
+        * @brief Streams a raw row-major binary file of T through a read-only memory mapping.
+        * The kernel reads ahead sequentially and drops pages already consumed, so the resident
+        * size stays near one block even for files larger than memory.
+        * @throws std::invalid_argument if cols or blockRows is 0.
+        * @throws std::runtime_error if the file cannot be mapped or is not a whole number of rows.
+        */
+
+        template<class T>
+        RowStream<T> readMappedBlocks(std::string path, size_t cols, size_t blockRows)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Mapped streams need trivially copyable elements.");
+            if (cols == 0 || blockRows == 0) {
+                throw std::invalid_argument("Blocks must have at least one row and one column!");
+            }
+            struct Mapping
+            {
+                int fd = -1;
+                void* data = MAP_FAILED;
+                size_t bytes = 0;
+
+                ~Mapping()
+                {
+                    if (data != MAP_FAILED) {
+                        munmap(data, bytes);
+                    }
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                }
+            } mapping;
+
+            mapping.fd = open(path.c_str(), O_RDONLY);
+            struct stat info;
+            if (mapping.fd < 0 || fstat(mapping.fd, &info) != 0) {
+                throw std::runtime_error("Cannot open matrix file " + path + ".");
+            }
+            mapping.bytes = static_cast<size_t>(info.st_size);
+            const size_t rowBytes = cols * sizeof(T);
+            if (mapping.bytes % rowBytes != 0) {
+                throw std::runtime_error("Matrix file " + path + " does not hold a whole number of rows.");
+            }
+            if (mapping.bytes == 0) {
+                co_return;
+            }
+            mapping.data = mmap(nullptr, mapping.bytes, PROT_READ, MAP_PRIVATE, mapping.fd, 0);
+            if (mapping.data == MAP_FAILED) {
+                throw std::runtime_error("Cannot map matrix file " + path + ".");
+            }
+            madvise(mapping.data, mapping.bytes, MADV_SEQUENTIAL);
+
+            const char* bytes = static_cast<const char*>(mapping.data);
+            const size_t totalRows = mapping.bytes / rowBytes;
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            for (size_t first = 0; first < totalRows; first += blockRows) {
+                const size_t rows = std::min(blockRows, totalRows - first);
+                RowBlock<T> block = detail::emptyBlock<T>(first, rows, cols);
+                std::memcpy(block.values.data(), bytes + first * rowBytes, rows * rowBytes);
+                const size_t consumed = (first + rows) * rowBytes / page * page;
+                if (consumed > 0) {
+                    madvise(mapping.data, consumed, MADV_DONTNEED);
+                }
+                co_yield std::move(block);
+            }
+        }
+
+#endif
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Lazy stages
+        //
+        // A stage takes its source by value and pulls one block per block it yields. Stages run on
+        // the consumer's thread, put prefetchBlocks() between two stages to run everything
+        // upstream of it on a thread of its own.
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        // Replaces every element x by f(x).
+        template<class T, class F>
+        RowStream<T> transformBlocks(RowStream<T> source, F f)
+        {
+            for (auto& block : source) {
+                for (auto& value : block.values) {
+                    value = f(value);
+                }
+                co_yield std::move(block);
+            }
+        }
+
+        // Calls f(block) on every block, for row-wise work such as normalizing each row.
+        template<class T, class F>
+        RowStream<T> applyBlocks(RowStream<T> source, F f)
+        {
+            for (auto& block : source) {
+                f(block);
+                co_yield std::move(block);
+            }
+        }
+
+        /**
+        * @brief Runs the source on a producer thread, up to capacity blocks ahead of the consumer.
+        * With a parsing source this overlaps parsing with the compute downstream. Memory stays
+        * bounded by capacity + 2 blocks. Exceptions of the source reach the consumer, and a
+        * consumer that stops early stops the producer after the block it is working on.
+        */
+
+        template<class T>
+        RowStream<T> prefetchBlocks(RowStream<T> source, size_t capacity = 4)
+        {
+            detail::BlockQueue<T> queue(capacity);
+            std::thread producer([&queue, upstream = std::move(source)]() mutable {
+                try {
+                    for (auto& block : upstream) {
+                        if (!queue.push(std::move(block))) {
+                            return;
+                        }
+                    }
+                    queue.close();
+                }
+                catch (...) {
+                    queue.close(std::current_exception());
+                }
+            });
+            detail::ProducerGuard<T> guard{ queue, producer };
+
+            while (auto block = queue.pop()) {
+                co_yield std::move(*block);
+            }
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Sinks
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        // Folds op(accumulator, x) over every element in stream order.
+        template<class T, class Acc, class Op>
+        Acc reduceBlocks(RowStream<T> source, Acc init, Op op)
+        {
+            for (auto& block : source) {
+                for (const auto& value : block.values) {
+                    init = op(std::move(init), value);
+                }
+            }
+            return init;
+        }
+
+        // Sum of all elements, with the lane-wise summation of the Matrix reductions per block.
+        template<class T>
+        T sumBlocks(RowStream<T> source)
+        {
+            T total{};
+            for (auto& block : source) {
+                total += detail::laneSum<T>(block.values.data(), block.values.size(), [](const T& x) { return x; });
+            }
+            return total;
+        }
+
+        /**
+        * @brief Materializes the stream as a matrix.
+        * @throws std::invalid_argument if blocks have different numbers of columns.
+        */
+
+        template<class T>
+        Matrix<T> collectBlocks(RowStream<T> source)
+        {
+            std::vector<RowBlock<T>> blocks;
+            size_t rows = 0;
+            for (auto& block : source) {
+                if (!blocks.empty() && block.cols != blocks.front().cols) {
+                    throw std::invalid_argument("All blocks of a stream must have the same number of columns!");
+                }
+                rows += block.rows;
+                blocks.push_back(std::move(block));
+            }
+            Matrix<T> result(rows, blocks.empty() ? 0 : blocks.front().cols, zeroFill);
+            size_t row = 0;
+            for (const auto& block : blocks) {
+                for (size_t i = 0; i < block.rows; ++i, ++row) {
+                    std::copy(block.row(i), block.row(i) + block.cols, result.rowData(row));
+                }
+            }
+            return result;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif
+
+#endif /* __STREAMING_HPP__ */
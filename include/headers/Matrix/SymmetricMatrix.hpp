@@ -0,0 +1,399 @@
+#ifndef __SYMMETRICMATRIX_HPP__
+#define __SYMMETRICMATRIX_HPP__
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <utility>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Symmetric matrix holding only its lower triangle, packed row by row.
+         * Needs n (n + 1) / 2 elements instead of n^2. The dense storage of the base class stays
+         * empty, which is why Matrix<T> is a protected base: routines that take a general Matrix<T>
+         * get one through toMatrix().
+         */
+        template <class T>
+        class SymmetricMatrix : protected Matrix<T>
+        {
+        public:
+            SymmetricMatrix() = default;
+            SymmetricMatrix(const std::initializer_list<std::initializer_list<T>>& list, const std::string = "SymmetricMatrix"); // full rows or lower triangle rows
+            SymmetricMatrix(size_t size, bool random = false, const std::string = "SymmetricMatrix"); // @param random generates by default the identity otherwise random numbers between [5000, - 2000]
+            explicit SymmetricMatrix(const Matrix<T>& matrix, const std::string = "SymmetricMatrix"); // takes the lower triangle of matrix
+            SymmetricMatrix(size_t size, std::vector<T> packed, const std::string = "SymmetricMatrix"); // adopts a packed lower triangle
+
+            ~SymmetricMatrix() = default;
+
+        public:
+            SymmetricMatrix& operator +=(const SymmetricMatrix& m1);
+            SymmetricMatrix& operator -=(const SymmetricMatrix& m1);
+            SymmetricMatrix& operator *=(const T& scalar);
+
+            template<class U> friend std::ostream& operator<<(std::ostream& os, const SymmetricMatrix<U>& m);
+
+        public:
+            using Matrix<T>::getRows;
+            using Matrix<T>::getCols;
+
+            T getElement(size_t row, size_t col) const; // get element at index row, column
+            void setElement(size_t row, size_t col, T element); // set element at index row, column and its mirror
+
+            std::vector<T> getDiagonal() const; // get diagonal of matrix
+            const std::vector<T>& getPacked() const; // packed lower triangle, row by row
+            Matrix<T> toMatrix() const; // expand to a dense matrix
+
+        private:
+            size_t index(size_t row, size_t col) const;
+
+        private:
+            std::vector<T> m_packed;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SymmetricMatrix class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief SymmetricMatrix constructor from initializer list
+         * Accepts either the full square matrix, which must be symmetric, or only the rows of the
+         * lower triangle where row i has i + 1 elements.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::SymmetricMatrix<float> s{
+         *     {4},
+         *     {1, 3},
+         *     {2, 0, 5}
+         * };
+         * \endcode
+         *
+         * @param list Initializer list of initializer lists representing the matrix.
+         * @param name Name of the matrix.
+         * @throw std::invalid_argument If the rows describe neither a lower triangle nor a symmetric matrix
+         * @tparam T Type of matrix elements.
+         */
+
+        template <class T>
+        SymmetricMatrix<T>::SymmetricMatrix(const std::initializer_list<std::initializer_list<T>>& list, const std::string name)
+        {
+            const size_t n = list.size();
+            this->setRows(n);
+            this->setCols(n);
+            this->setName(name);
+            m_packed.resize(detail::packedSize(n));
+
+            bool triangle = true;
+            bool square = true;
+            size_t i = 0;
+            for (const auto& row : list) {
+                triangle = triangle && row.size() == i + 1;
+                square = square && row.size() == n;
+                i++;
+            }
+            if (!triangle && !square) {
+                throw std::invalid_argument("Rows must form a square matrix or its lower triangle!");
+            }
+
+            i = 0;
+            for (const auto& row : list) {
+                size_t j = 0;
+                for (const auto& element : row) {
+                    if (j <= i) {
+                        m_packed[index(i, j)] = element;
+                    }
+                    j++;
+                }
+                i++;
+            }
+
+            if (square && !triangle) {
+                i = 0;
+                for (const auto& row : list) {
+                    size_t j = 0;
+                    for (const auto& element : row) {
+                        if (j > i && element != m_packed[index(i, j)]) {
+                            throw std::invalid_argument("Matrix is not symmetric!");
+                        }
+                        j++;
+                    }
+                    i++;
+                }
+            }
+        }
+
+        template <class T>
+        SymmetricMatrix<T>::SymmetricMatrix(size_t size, bool random, const std::string name)
+        {
+            this->setRows(size);
+            this->setCols(size);
+            this->setName(name);
+            m_packed.assign(detail::packedSize(size), static_cast<T>(0));
+
+            if (random) {
+                std::random_device rd;
+                std::mt19937 gen(rd());
+                detail::UniformElement<T> dis;
+                for (auto& element : m_packed) {
+                    element = dis(gen);
+                }
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    m_packed[index(i, i)] = static_cast<T>(1);
+                }
+            }
+        }
+
+        template <class T>
+        SymmetricMatrix<T>::SymmetricMatrix(const Matrix<T>& matrix, const std::string name)
+        {
+            if (matrix.getRows() != matrix.getCols()) {
+                throw std::invalid_argument("Symmetric matrix must be square!");
+            }
+            const size_t n = matrix.getRows();
+            this->setRows(n);
+            this->setCols(n);
+            this->setName(name);
+            m_packed.resize(detail::packedSize(n));
+
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j <= i; ++j) {
+                    m_packed[index(i, j)] = matrix.getElement(i, j);
+                }
+            }
+        }
+
+        template <class T>
+        SymmetricMatrix<T>::SymmetricMatrix(size_t size, std::vector<T> packed, const std::string name)
+            : m_packed(std::move(packed))
+        {
+            if (m_packed.size() != detail::packedSize(size)) {
+                throw std::invalid_argument("Packed storage must hold size * (size + 1) / 2 elements!");
+            }
+            this->setRows(size);
+            this->setCols(size);
+            this->setName(name);
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SymmetricMatrix class operators
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template <class T>
+        inline SymmetricMatrix<T>& SymmetricMatrix<T>::operator+=(const SymmetricMatrix<T>& m1)
+        {
+            if (getRows() != m1.getRows()) {
+                throw std::invalid_argument("Matrices must have the same dimensions.");
+            }
+            for (size_t i = 0; i < m_packed.size(); ++i) {
+                m_packed[i] += m1.m_packed[i];
+            }
+            return *this;
+        }
+
+        template <class T>
+        inline SymmetricMatrix<T>& SymmetricMatrix<T>::operator-=(const SymmetricMatrix<T>& m1)
+        {
+            if (getRows() != m1.getRows()) {
+                throw std::invalid_argument("Matrices must have the same dimensions.");
+            }
+            for (size_t i = 0; i < m_packed.size(); ++i) {
+                m_packed[i] -= m1.m_packed[i];
+            }
+            return *this;
+        }
+
+        template <class T>
+        inline SymmetricMatrix<T>& SymmetricMatrix<T>::operator*=(const T& scalar)
+        {
+            for (auto& element : m_packed) {
+                element *= scalar;
+            }
+            return *this;
+        }
+
+        template<class U>
+        inline std::ostream& operator<<(std::ostream& os, const SymmetricMatrix<U>& m)
+        {
+            return os << m.toMatrix();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // SymmetricMatrix class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template <class T>
+        inline size_t SymmetricMatrix<T>::index(size_t row, size_t col) const
+        {
+            if (row < col) {
+                std::swap(row, col);
+            }
+            return row * (row + 1) / 2 + col;
+        }
+
+        template <class T>
+        inline T SymmetricMatrix<T>::getElement(size_t row, size_t col) const
+        {
+            if (row >= getRows() || col >= getCols()) {
+                throw std::out_of_range("Index out of range.");
+            }
+            return m_packed[index(row, col)];
+        }
+
+        template <class T>
+        inline void SymmetricMatrix<T>::setElement(size_t row, size_t col, T element)
+        {
+            if (row >= getRows() || col >= getCols()) {
+                throw std::out_of_range("Index out of range.");
+            }
+            m_packed[index(row, col)] = element;
+        }
+
+        template <class T>
+        inline std::vector<T> SymmetricMatrix<T>::getDiagonal() const
+        {
+            std::vector<T> diagonal(getRows());
+            for (size_t i = 0; i < getRows(); ++i) {
+                diagonal[i] = m_packed[index(i, i)];
+            }
+            return diagonal;
+        }
+
+        template <class T>
+        inline const std::vector<T>& SymmetricMatrix<T>::getPacked() const
+        {
+            return m_packed;
+        }
+
+        template <class T>
+        inline Matrix<T> SymmetricMatrix<T>::toMatrix() const
+        {
+            Matrix<T> result(getRows(), getCols(), zeroFill);
+            for (size_t i = 0; i < getRows(); ++i) {
+                for (size_t j = 0; j < getCols(); ++j) {
+                    result.getElement(i, j) = m_packed[index(i, j)];
+                }
+            }
+            return result;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Symmetric kernels and products
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Symmetric rank-k update (SYRK).
+        * Computes the Gram matrix A^T * A, or A * A^T if transpose is false, touching only the lower
+        * triangle of the result.
+        *
+        * @param a The input matrix.
+        * @param transpose Selects A^T * A (default) or A * A^T.
+        * @return The symmetric product in packed storage.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline SymmetricMatrix<T> syrk(const Matrix<T>& a, bool transpose = true)
+        {
+            const size_t n = transpose ? a.getCols() : a.getRows();
+            const size_t k = transpose ? a.getRows() : a.getCols();
+            std::vector<T> packed(detail::packedSize(n));
+            std::vector<T> buffer = detail::pack(a);
+
+            if (transpose) {
+                detail::syrkTransposed(n, k, buffer.data(), a.getCols(), detail::PackedLowerRows<T>{ packed.data() });
+            } else {
+                detail::syrk(n, k, buffer.data(), a.getCols(), detail::PackedLowerRows<T>{ packed.data() });
+            }
+            return SymmetricMatrix<T>(n, std::move(packed));
+        }
+
+
+        /**
+        * @brief Multiplies a symmetric matrix with a general matrix (SYMM).
+        * @throws std::invalid_argument if matrices have incompatible dimensions.
+        * @return Resultant matrix of the multiplication.
+        * @tparam U Type of matrix elements.
+        */
+
+        template<class U>
+        inline Matrix<U> operator*(const SymmetricMatrix<U>& s, const Matrix<U>& m)
+        {
+            if (s.getCols() != m.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            Matrix<U> result(s.getRows(), m.getCols(), zeroFill);
+            std::vector<U> b = detail::pack(m);
+            std::vector<U> c(s.getRows() * m.getCols());
+            detail::symmLeft(s.getRows(), m.getCols(), detail::PackedLowerRows<const U>{ s.getPacked().data() },
+                             b.data(), m.getCols(), c.data(), m.getCols());
+            detail::unpack(c.data(), m.getCols(), result);
+            return result;
+        }
+
+        template<class U>
+        inline Matrix<U> operator*(const Matrix<U>& m, const SymmetricMatrix<U>& s)
+        {
+            if (m.getCols() != s.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            Matrix<U> result(m.getRows(), s.getCols(), zeroFill);
+            std::vector<U> b = detail::pack(m);
+            std::vector<U> c(m.getRows() * s.getCols());
+            detail::symmRight(m.getRows(), s.getCols(), b.data(), m.getCols(),
+                              detail::PackedLowerRows<const U>{ s.getPacked().data() }, c.data(), s.getCols());
+            detail::unpack(c.data(), s.getCols(), result);
+            return result;
+        }
+
+        template<class U>
+        inline Matrix<U> operator*(const SymmetricMatrix<U>& s1, const SymmetricMatrix<U>& s2)
+        {
+            return s1 * s2.toMatrix();
+        }
+
+        template<class U>
+        inline SymmetricMatrix<U> operator*(const SymmetricMatrix<U>& s, const U& scalar)
+        {
+            SymmetricMatrix<U> result(s);
+            result *= scalar;
+            return result;
+        }
+
+        template<class U>
+        inline SymmetricMatrix<U> operator*(const U& scalar, const SymmetricMatrix<U>& s)
+        {
+            return s * scalar;
+        }
+
+        template<class U>
+        inline SymmetricMatrix<U> operator+(const SymmetricMatrix<U>& s1, const SymmetricMatrix<U>& s2)
+        {
+            SymmetricMatrix<U> result(s1);
+            result += s2;
+            return result;
+        }
+
+        template<class U>
+        inline SymmetricMatrix<U> operator-(const SymmetricMatrix<U>& s1, const SymmetricMatrix<U>& s2)
+        {
+            SymmetricMatrix<U> result(s1);
+            result -= s2;
+            return result;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __SYMMETRICMATRIX_HPP__ */
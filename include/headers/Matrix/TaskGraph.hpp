@@ -0,0 +1,744 @@
+#ifndef __TASKGRAPH_HPP__
+#define __TASKGRAPH_HPP__
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <exception>
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        class TaskGraph;
+        template<class T> class AsyncMatrix;
+
+        namespace detail
+        {
+            /**
+             * @brief Vertex of the task graph.
+             * A node is split into tiles, each tile is one job on the thread pool. A tile becomes
+             * ready once every tile or node it depends on has finished, so dependent operations start
+             * on the first finished tiles of their inputs instead of waiting for the whole input.
+             */
+            class GraphNode : public std::enable_shared_from_this<GraphNode>
+            {
+            public:
+                GraphNode(TaskGraph* graph, size_t tiles);
+                virtual ~GraphNode() = default;
+
+            public:
+                void wait() const; // block until every tile has finished
+                bool ready() const; // true once every tile has finished
+                std::exception_ptr error() const; // first exception thrown by this node or its inputs
+                TaskGraph* graph() const;
+                size_t getTileCount() const;
+
+                void addInput(std::shared_ptr<GraphNode> input); // keeps input alive and propagates its errors
+                void dependOnTile(GraphNode& input, size_t inputTile, size_t tile); // tile waits for one tile of input
+                void dependOnNode(GraphNode& input, size_t tile); // tile waits for all of input
+                void arm(); // called once all dependencies are registered
+                void complete(); // mark a node without work as finished
+
+                void release(size_t tile); // one dependency of tile finished
+                void execute(size_t tile); // run tile on the calling thread
+
+            protected:
+                virtual void compute(size_t tile) = 0;
+                virtual void fail(std::exception_ptr) {}
+
+            private:
+                using Dependent = std::pair<std::shared_ptr<GraphNode>, size_t>;
+
+                struct Tile
+                {
+                    std::atomic<size_t> pending{ 1 }; // the 1 guards the tile until arm()
+                    bool done = false;
+                    std::vector<Dependent> dependents;
+                };
+
+                void finish(size_t tile);
+
+            private:
+                TaskGraph* m_graph;
+                size_t m_tileCount;
+                std::unique_ptr<Tile[]> m_tiles;
+                size_t m_remaining;
+                bool m_done = false;
+                std::vector<Dependent> m_nodeDependents;
+                std::vector<std::shared_ptr<GraphNode>> m_inputs;
+                std::exception_ptr m_error;
+                mutable std::mutex m_mutex;
+                mutable std::condition_variable m_condition;
+            };
+
+
+            /**
+             * @brief Node producing a matrix, computed band of tileRows rows per tile into a
+             * contiguous row-major buffer.
+             */
+            template<class T>
+            class MatrixNode : public GraphNode
+            {
+            public:
+                using Kernel = std::function<void(MatrixNode<T>&, size_t, size_t)>; // (node, rowBegin, rowEnd)
+
+                MatrixNode(TaskGraph* graph, size_t rows, size_t cols, size_t tileRows, Kernel kernel = Kernel());
+
+            public:
+                const Matrix<T>& matrix() const; // result as Matrix<T>, only valid once ready()
+
+                size_t rows;
+                size_t cols;
+                size_t tileRows;
+                std::vector<T> data;
+                std::vector<std::shared_ptr<MatrixNode<T>>> operands;
+
+            protected:
+                void compute(size_t tile) override;
+
+            private:
+                Kernel m_kernel;
+                mutable std::once_flag m_materialized;
+                mutable std::unique_ptr<Matrix<T>> m_matrix;
+            };
+
+
+            /**
+             * @brief Single-tile node running a continuation and fulfilling a promise with its result.
+             */
+            template<class R>
+            class CallbackNode : public GraphNode
+            {
+            public:
+                CallbackNode(TaskGraph* graph, std::function<R()> callback);
+
+                std::shared_future<R> future() const;
+
+            protected:
+                void compute(size_t) override;
+                void fail(std::exception_ptr error) override;
+
+            private:
+                std::function<R()> m_callback;
+                std::promise<R> m_promise;
+                std::shared_future<R> m_future;
+            };
+
+        }; // end namespace detail
+
+
+        /**
+         * @brief Schedules matrix operations as a dependency graph on a thread pool.
+         * Every operation returns an AsyncMatrix handle immediately. Independent operations run
+         * concurrently, and elementwise operations and the rows of products are split into row bands
+         * that start as soon as the matching bands of their inputs are finished.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::TaskGraph graph;
+         * auto a = graph.input(A);
+         * auto b = graph.input(B);
+         * auto c = a * b + transpose(b) * 2.0; // both products run concurrently
+         * c.then([](const Matrix<double>& m) { std::cout << m; });
+         * const auto& result = c.get();
+         * \endcode
+         *
+         * Handles can be read after the graph is destroyed, but new operations need a live graph.
+         * The destructor waits for all scheduled work.
+         */
+        class TaskGraph
+        {
+        public:
+            explicit TaskGraph(size_t threads = std::thread::hardware_concurrency(), size_t tileRows = 64);
+            TaskGraph(const TaskGraph&) = delete;
+            TaskGraph& operator=(const TaskGraph&) = delete;
+
+            ~TaskGraph();
+
+        public:
+            template<class T> AsyncMatrix<T> input(const Matrix<T>& m); // ready node holding a copy of m
+            template<class T> AsyncMatrix<T> add(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2); // m1 + m2
+            template<class T> AsyncMatrix<T> subtract(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2); // m1 - m2
+            template<class T> AsyncMatrix<T> multiply(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2); // m1 * m2
+            template<class T> AsyncMatrix<T> scale(const AsyncMatrix<T>& m1, const T& scalar); // m1 * scalar
+            template<class T> AsyncMatrix<T> transpose(const AsyncMatrix<T>& m1); // m1^T
+
+            void waitAll(); // block until no scheduled tile is left
+            size_t getTileRows() const;
+
+            void schedule(std::shared_ptr<detail::GraphNode> node, size_t tile); // queue a ready tile
+            void taskFinished(); // bookkeeping of waitAll()
+
+        private:
+            template<class T, class Op>
+            AsyncMatrix<T> elementwise(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2, Op op);
+
+            template<class T>
+            void checkOwner(const AsyncMatrix<T>& m) const;
+
+        private:
+            size_t m_tileRows;
+            std::atomic<size_t> m_outstanding{ 0 };
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            ThreadPool m_pool; // declared last so its workers are joined before the members above go away
+        };
+
+
+        /**
+         * @brief Handle of a matrix computed by a TaskGraph.
+         */
+        template<class T>
+        class AsyncMatrix
+        {
+        public:
+            AsyncMatrix() = default;
+            explicit AsyncMatrix(std::shared_ptr<detail::MatrixNode<T>> node);
+
+        public:
+            const Matrix<T>& get() const; // wait for the result, rethrows errors of the computation
+            void wait() const; // wait for the result
+            bool ready() const; // true if the result is available
+
+            template<class F>
+            auto then(F&& f) const -> std::shared_future<std::invoke_result_t<F, const Matrix<T>&>>; // run f(result) once ready
+
+            size_t getRows() const;
+            size_t getCols() const;
+            const std::shared_ptr<detail::MatrixNode<T>>& node() const;
+
+        private:
+            std::shared_ptr<detail::MatrixNode<T>> m_node;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // GraphNode class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        namespace detail
+        {
+            inline GraphNode::GraphNode(TaskGraph* graph, size_t tiles)
+                : m_graph(graph)
+                , m_tileCount(tiles)
+                , m_tiles(new Tile[tiles])
+                , m_remaining(tiles)
+            {}
+
+            inline void GraphNode::wait() const
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_done; });
+            }
+
+            inline bool GraphNode::ready() const
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_done;
+            }
+
+            inline std::exception_ptr GraphNode::error() const
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_error;
+            }
+
+            inline TaskGraph* GraphNode::graph() const
+            {
+                return m_graph;
+            }
+
+            inline size_t GraphNode::getTileCount() const
+            {
+                return m_tileCount;
+            }
+
+            inline void GraphNode::addInput(std::shared_ptr<GraphNode> input)
+            {
+                m_inputs.push_back(std::move(input));
+            }
+
+            inline void GraphNode::dependOnTile(GraphNode& input, size_t inputTile, size_t tile)
+            {
+                std::lock_guard<std::mutex> lock(input.m_mutex);
+                if (!input.m_tiles[inputTile].done) {
+                    input.m_tiles[inputTile].dependents.emplace_back(shared_from_this(), tile);
+                    m_tiles[tile].pending++;
+                }
+            }
+
+            inline void GraphNode::dependOnNode(GraphNode& input, size_t tile)
+            {
+                std::lock_guard<std::mutex> lock(input.m_mutex);
+                if (!input.m_done) {
+                    input.m_nodeDependents.emplace_back(shared_from_this(), tile);
+                    m_tiles[tile].pending++;
+                }
+            }
+
+            inline void GraphNode::arm()
+            {
+                if (m_tileCount == 0) {
+                    complete();
+                    return;
+                }
+                for (size_t tile = 0; tile < m_tileCount; ++tile) {
+                    release(tile);
+                }
+            }
+
+            inline void GraphNode::complete()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (size_t tile = 0; tile < m_tileCount; ++tile) {
+                        m_tiles[tile].done = true;
+                    }
+                    m_remaining = 0;
+                    m_done = true;
+                }
+                m_condition.notify_all();
+            }
+
+            inline void GraphNode::release(size_t tile)
+            {
+                if (m_tiles[tile].pending.fetch_sub(1) == 1) {
+                    m_graph->schedule(shared_from_this(), tile);
+                }
+            }
+
+            inline void GraphNode::execute(size_t tile)
+            {
+                std::exception_ptr failure;
+                for (const auto& input : m_inputs) {
+                    failure = input->error();
+                    if (failure) {
+                        break;
+                    }
+                }
+                if (!failure && !error()) {
+                    try {
+                        compute(tile);
+                    } catch (...) {
+                        failure = std::current_exception();
+                    }
+                }
+
+                if (failure) {
+                    bool first = false;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!m_error) {
+                            m_error = failure;
+                            first = true;
+                        }
+                    }
+                    if (first) {
+                        fail(failure);
+                    }
+                }
+                finish(tile);
+            }
+
+            inline void GraphNode::finish(size_t tile)
+            {
+                std::vector<Dependent> ready;
+                bool done = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_tiles[tile].done = true;
+                    ready = std::move(m_tiles[tile].dependents);
+                    if (--m_remaining == 0) {
+                        m_done = done = true;
+                        ready.insert(ready.end(), m_nodeDependents.begin(), m_nodeDependents.end());
+                        m_nodeDependents.clear();
+                    }
+                }
+                if (done) {
+                    m_condition.notify_all();
+                }
+                for (auto& dependent : ready) {
+                    dependent.first->release(dependent.second);
+                }
+                m_graph->taskFinished();
+            }
+
+
+            // ////////////////////////////////////////////////////////////////////////////////////////
+            // MatrixNode and CallbackNode class methodes
+            // ////////////////////////////////////////////////////////////////////////////////////////
+
+            template<class T>
+            MatrixNode<T>::MatrixNode(TaskGraph* graph, size_t rows, size_t cols, size_t tileRows, Kernel kernel)
+                : GraphNode(graph, (rows + tileRows - 1) / tileRows)
+                , rows(rows)
+                , cols(cols)
+                , tileRows(tileRows)
+                , data(rows * cols)
+                , m_kernel(std::move(kernel))
+            {}
+
+            template<class T>
+            inline void MatrixNode<T>::compute(size_t tile)
+            {
+                const size_t rowBegin = tile * tileRows;
+                const size_t rowEnd = std::min(rowBegin + tileRows, rows);
+                m_kernel(*this, rowBegin, rowEnd);
+            }
+
+            template<class T>
+            inline const Matrix<T>& MatrixNode<T>::matrix() const
+            {
+                std::call_once(m_materialized, [this]() {
+                    m_matrix.reset(new Matrix<T>(rows, cols, zeroFill));
+                    unpack(data.data(), cols, *m_matrix);
+                });
+                return *m_matrix;
+            }
+
+            template<class R>
+            CallbackNode<R>::CallbackNode(TaskGraph* graph, std::function<R()> callback)
+                : GraphNode(graph, 1)
+                , m_callback(std::move(callback))
+                , m_future(m_promise.get_future().share())
+            {}
+
+            template<class R>
+            inline std::shared_future<R> CallbackNode<R>::future() const
+            {
+                return m_future;
+            }
+
+            template<class R>
+            inline void CallbackNode<R>::compute(size_t)
+            {
+                if constexpr (std::is_void_v<R>) {
+                    m_callback();
+                    m_promise.set_value();
+                } else {
+                    m_promise.set_value(m_callback());
+                }
+            }
+
+            template<class R>
+            inline void CallbackNode<R>::fail(std::exception_ptr error)
+            {
+                m_promise.set_exception(error);
+            }
+
+        }; // end namespace detail
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // TaskGraph class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        inline TaskGraph::TaskGraph(size_t threads, size_t tileRows)
+            : m_tileRows(std::max<size_t>(tileRows, 1))
+            , m_pool(threads)
+        {}
+
+        inline TaskGraph::~TaskGraph()
+        {
+            waitAll();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // TaskGraph class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        inline void TaskGraph::schedule(std::shared_ptr<detail::GraphNode> node, size_t tile)
+        {
+            m_outstanding++;
+            m_pool.submit([node, tile]() { node->execute(tile); });
+        }
+
+        inline void TaskGraph::taskFinished()
+        {
+            if (--m_outstanding == 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_condition.notify_all();
+            }
+        }
+
+        inline void TaskGraph::waitAll()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_outstanding == 0; });
+        }
+
+        inline size_t TaskGraph::getTileRows() const
+        {
+            return m_tileRows;
+        }
+
+        template<class T>
+        inline void TaskGraph::checkOwner(const AsyncMatrix<T>& m) const
+        {
+            if (!m.node() || m.node()->graph() != this) {
+                throw std::invalid_argument("Matrix handle does not belong to this task graph.");
+            }
+        }
+
+        template<class T>
+        inline AsyncMatrix<T> TaskGraph::input(const Matrix<T>& m)
+        {
+            auto node = std::make_shared<detail::MatrixNode<T>>(this, m.getRows(), m.getCols(), m_tileRows);
+            node->data = detail::pack(m);
+            node->complete();
+            return AsyncMatrix<T>(node);
+        }
+
+        template<class T, class Op>
+        inline AsyncMatrix<T> TaskGraph::elementwise(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2, Op op)
+        {
+            checkOwner(m1);
+            checkOwner(m2);
+            if (m1.getRows() != m2.getRows() || m1.getCols() != m2.getCols()) {
+                throw std::invalid_argument("Matrices must have the same dimensions.");
+            }
+
+            auto node = std::make_shared<detail::MatrixNode<T>>(this, m1.getRows(), m1.getCols(), m_tileRows,
+                [op](detail::MatrixNode<T>& self, size_t rowBegin, size_t rowEnd) {
+                    const T* x = self.operands[0]->data.data();
+                    const T* y = self.operands[1]->data.data();
+                    T* out = self.data.data();
+                    for (size_t i = rowBegin * self.cols; i < rowEnd * self.cols; ++i) {
+                        out[i] = op(x[i], y[i]);
+                    }
+                });
+            node->operands = { m1.node(), m2.node() };
+            node->addInput(m1.node());
+            node->addInput(m2.node());
+            for (size_t tile = 0; tile < node->getTileCount(); ++tile) {
+                node->dependOnTile(*m1.node(), tile, tile);
+                node->dependOnTile(*m2.node(), tile, tile);
+            }
+            node->arm();
+            return AsyncMatrix<T>(node);
+        }
+
+        template<class T>
+        inline AsyncMatrix<T> TaskGraph::add(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2)
+        {
+            return elementwise(m1, m2, [](const T& x, const T& y) { return x + y; });
+        }
+
+        template<class T>
+        inline AsyncMatrix<T> TaskGraph::subtract(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2)
+        {
+            return elementwise(m1, m2, [](const T& x, const T& y) { return x - y; });
+        }
+
+
+        /**
+        * @brief Schedules m1 * m2.
+        * Row band i of the result waits for row band i of m1 and all of m2, so it can start while
+        * later bands of m1 are still being computed.
+        * @throws std::invalid_argument if matrices have incompatible dimensions.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline AsyncMatrix<T> TaskGraph::multiply(const AsyncMatrix<T>& m1, const AsyncMatrix<T>& m2)
+        {
+            checkOwner(m1);
+            checkOwner(m2);
+            if (m1.getCols() != m2.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+
+            auto node = std::make_shared<detail::MatrixNode<T>>(this, m1.getRows(), m2.getCols(), m_tileRows,
+                [](detail::MatrixNode<T>& self, size_t rowBegin, size_t rowEnd) {
+                    const auto& a = *self.operands[0];
+                    const auto& b = *self.operands[1];
+                    detail::gemm(rowEnd - rowBegin, self.cols, a.cols,
+                                 a.data.data() + rowBegin * a.cols, a.cols,
+                                 b.data.data(), b.cols,
+                                 self.data.data() + rowBegin * self.cols, self.cols);
+                });
+            node->operands = { m1.node(), m2.node() };
+            node->addInput(m1.node());
+            node->addInput(m2.node());
+            for (size_t tile = 0; tile < node->getTileCount(); ++tile) {
+                node->dependOnTile(*m1.node(), tile, tile);
+                node->dependOnNode(*m2.node(), tile);
+            }
+            node->arm();
+            return AsyncMatrix<T>(node);
+        }
+
+        template<class T>
+        inline AsyncMatrix<T> TaskGraph::scale(const AsyncMatrix<T>& m1, const T& scalar)
+        {
+            checkOwner(m1);
+            auto node = std::make_shared<detail::MatrixNode<T>>(this, m1.getRows(), m1.getCols(), m_tileRows,
+                [scalar](detail::MatrixNode<T>& self, size_t rowBegin, size_t rowEnd) {
+                    const T* x = self.operands[0]->data.data();
+                    T* out = self.data.data();
+                    for (size_t i = rowBegin * self.cols; i < rowEnd * self.cols; ++i) {
+                        out[i] = x[i] * scalar;
+                    }
+                });
+            node->operands = { m1.node() };
+            node->addInput(m1.node());
+            for (size_t tile = 0; tile < node->getTileCount(); ++tile) {
+                node->dependOnTile(*m1.node(), tile, tile);
+            }
+            node->arm();
+            return AsyncMatrix<T>(node);
+        }
+
+        template<class T>
+        inline AsyncMatrix<T> TaskGraph::transpose(const AsyncMatrix<T>& m1)
+        {
+            checkOwner(m1);
+            auto node = std::make_shared<detail::MatrixNode<T>>(this, m1.getCols(), m1.getRows(), m_tileRows,
+                [](detail::MatrixNode<T>& self, size_t rowBegin, size_t rowEnd) {
+                    const T* x = self.operands[0]->data.data();
+                    T* out = self.data.data();
+                    for (size_t i = rowBegin; i < rowEnd; ++i) {
+                        for (size_t j = 0; j < self.cols; ++j) {
+                            out[i * self.cols + j] = x[j * self.rows + i];
+                        }
+                    }
+                });
+            node->operands = { m1.node() };
+            node->addInput(m1.node());
+            for (size_t tile = 0; tile < node->getTileCount(); ++tile) {
+                node->dependOnNode(*m1.node(), tile);
+            }
+            node->arm();
+            return AsyncMatrix<T>(node);
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // AsyncMatrix class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class T>
+        AsyncMatrix<T>::AsyncMatrix(std::shared_ptr<detail::MatrixNode<T>> node)
+            : m_node(std::move(node))
+        {}
+
+        template<class T>
+        inline const Matrix<T>& AsyncMatrix<T>::get() const
+        {
+            m_node->wait();
+            if (auto error = m_node->error()) {
+                std::rethrow_exception(error);
+            }
+            return m_node->matrix();
+        }
+
+        template<class T>
+        inline void AsyncMatrix<T>::wait() const
+        {
+            m_node->wait();
+        }
+
+        template<class T>
+        inline bool AsyncMatrix<T>::ready() const
+        {
+            return m_node->ready();
+        }
+
+
+        /**
+        * @brief Schedules f(result) on the graph's thread pool once this matrix is finished.
+        * @param f Callable taking const Matrix<T>&.
+        * @return Future of f's result, holds the exception if this matrix or f failed.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        template<class F>
+        inline auto AsyncMatrix<T>::then(F&& f) const -> std::shared_future<std::invoke_result_t<F, const Matrix<T>&>>
+        {
+            using R = std::invoke_result_t<F, const Matrix<T>&>;
+            auto source = m_node;
+            auto node = std::make_shared<detail::CallbackNode<R>>(m_node->graph(),
+                [source, f = std::forward<F>(f)]() mutable -> R { return f(source->matrix()); });
+            node->addInput(m_node);
+            node->dependOnNode(*m_node, 0);
+            node->arm();
+            return node->future();
+        }
+
+        template<class T>
+        inline size_t AsyncMatrix<T>::getRows() const
+        {
+            return m_node->rows;
+        }
+
+        template<class T>
+        inline size_t AsyncMatrix<T>::getCols() const
+        {
+            return m_node->cols;
+        }
+
+        template<class T>
+        inline const std::shared_ptr<detail::MatrixNode<T>>& AsyncMatrix<T>::node() const
+        {
+            return m_node;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // AsyncMatrix operators
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template<class U>
+        inline AsyncMatrix<U> operator+(const AsyncMatrix<U>& m1, const AsyncMatrix<U>& m2)
+        {
+            return m1.node()->graph()->add(m1, m2);
+        }
+
+        template<class U>
+        inline AsyncMatrix<U> operator-(const AsyncMatrix<U>& m1, const AsyncMatrix<U>& m2)
+        {
+            return m1.node()->graph()->subtract(m1, m2);
+        }
+
+        template<class U>
+        inline AsyncMatrix<U> operator*(const AsyncMatrix<U>& m1, const AsyncMatrix<U>& m2)
+        {
+            return m1.node()->graph()->multiply(m1, m2);
+        }
+
+        template<class U>
+        inline AsyncMatrix<U> operator*(const AsyncMatrix<U>& m1, const U& scalar)
+        {
+            return m1.node()->graph()->scale(m1, scalar);
+        }
+
+        template<class U>
+        inline AsyncMatrix<U> operator*(const U& scalar, const AsyncMatrix<U>& m1)
+        {
+            return m1.node()->graph()->scale(m1, scalar);
+        }
+
+        template<class U>
+        inline AsyncMatrix<U> transpose(const AsyncMatrix<U>& m1)
+        {
+            return m1.node()->graph()->transpose(m1);
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __TASKGRAPH_HPP__ */
@@ -0,0 +1,117 @@
+#ifndef __THREADPOOL_HPP__
+#define __THREADPOOL_HPP__
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+#include "Parallel.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Fixed-size pool of worker threads running submitted jobs in FIFO order.
+         * The destructor finishes every queued job, including jobs submitted by running jobs,
+         * before joining the workers. With pinning, worker i runs on logical CPU i.
+         */
+        class ThreadPool
+        {
+        public:
+            explicit ThreadPool(size_t threads = std::thread::hardware_concurrency(), bool pinThreads = getThreadPinning());
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            ~ThreadPool();
+
+        public:
+            void submit(std::function<void()> job); // enqueue job
+            size_t getThreadCount() const; // number of workers
+
+        private:
+            void work();
+
+        private:
+            std::vector<std::thread> m_workers;
+            std::queue<std::function<void()>> m_jobs;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            bool m_stop = false;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // ThreadPool class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        inline ThreadPool::ThreadPool(size_t threads, bool pinThreads)
+        {
+            const size_t count = std::max<size_t>(threads, 1);
+            m_workers.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                m_workers.emplace_back([this, i, pinThreads]() {
+                    if (pinThreads) {
+                        detail::pinCurrentThread(i);
+                    }
+                    work();
+                });
+            }
+        }
+
+        inline ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_condition.notify_all();
+            for (auto& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // ThreadPool class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        inline void ThreadPool::submit(std::function<void()> job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_jobs.push(std::move(job));
+            }
+            m_condition.notify_one();
+        }
+
+        inline size_t ThreadPool::getThreadCount() const
+        {
+            return m_workers.size();
+        }
+
+        inline void ThreadPool::work()
+        {
+            while (true) {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+                    if (m_jobs.empty()) {
+                        return;
+                    }
+                    job = std::move(m_jobs.front());
+                    m_jobs.pop();
+                }
+                job();
+            }
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __THREADPOOL_HPP__ */
@@ -0,0 +1,455 @@
+#ifndef __TRIANGULARMATRIX_HPP__
+#define __TRIANGULARMATRIX_HPP__
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <utility>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "SymmetricMatrix.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        enum class Triangle
+        {
+            Lower,
+            Upper
+        };
+
+
+        /**
+         * @brief Lower or upper triangular matrix holding only its triangle, packed row by row.
+         * Needs n (n + 1) / 2 elements instead of n^2. Like SymmetricMatrix the dense storage of the
+         * base class stays empty, general routines get a Matrix<T> through toMatrix().
+         */
+        template <class T>
+        class TriangularMatrix : protected Matrix<T>
+        {
+        public:
+            TriangularMatrix() = default;
+            TriangularMatrix(const std::initializer_list<std::initializer_list<T>>& list, Triangle triangle = Triangle::Lower, const std::string = "TriangularMatrix"); // full rows or triangle rows
+            TriangularMatrix(size_t size, Triangle triangle = Triangle::Lower, bool random = false, const std::string = "TriangularMatrix"); // @param random generates by default the identity otherwise random numbers between [5000, - 2000]
+            explicit TriangularMatrix(const Matrix<T>& matrix, Triangle triangle = Triangle::Lower, const std::string = "TriangularMatrix"); // takes the selected triangle of matrix
+
+            ~TriangularMatrix() = default;
+
+        public:
+            TriangularMatrix& operator +=(const TriangularMatrix& m1);
+            TriangularMatrix& operator -=(const TriangularMatrix& m1);
+            TriangularMatrix& operator *=(const T& scalar);
+
+            template<class U> friend std::ostream& operator<<(std::ostream& os, const TriangularMatrix<U>& m);
+
+        public:
+            using Matrix<T>::getRows;
+            using Matrix<T>::getCols;
+
+            T getElement(size_t row, size_t col) const; // get element at index row, column, zero outside the triangle
+            void setElement(size_t row, size_t col, T element); // set element at index row, column inside the triangle
+
+            Triangle getTriangle() const; // stored triangle
+            bool isLower() const; // true for lower triangular matrices
+            std::vector<T> getDiagonal() const; // get diagonal of matrix
+            const std::vector<T>& getPacked() const; // packed triangle, row by row
+            Matrix<T> toMatrix() const; // expand to a dense matrix
+
+            void transpose(); // transpose matrix, lower becomes upper and vice versa
+            Matrix<T> solve(const Matrix<T>& b) const; // solve this * x = b
+
+            template<class F>
+            auto withRows(F&& f) const; // calls f with the row accessor of the packed triangle
+
+        private:
+            bool contains(size_t row, size_t col) const;
+            size_t index(size_t row, size_t col) const;
+
+        private:
+            Triangle m_triangle = Triangle::Lower;
+            std::vector<T> m_packed;
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // TriangularMatrix class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @brief TriangularMatrix constructor from initializer list
+         * Accepts either the full square matrix, which must be zero outside the triangle, or only
+         * the rows of the triangle: i + 1 elements in row i for lower, n - i for upper matrices.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::TriangularMatrix<float> l{
+         *     {2},
+         *     {1, 3},
+         *     {4, 0, 5}
+         * };
+         * \endcode
+         *
+         * @param list Initializer list of initializer lists representing the matrix.
+         * @param triangle Stored triangle.
+         * @param name Name of the matrix.
+         * @throw std::invalid_argument If the rows describe neither the triangle nor a triangular matrix
+         * @tparam T Type of matrix elements.
+         */
+
+        template <class T>
+        TriangularMatrix<T>::TriangularMatrix(const std::initializer_list<std::initializer_list<T>>& list, Triangle triangle, const std::string name)
+            : m_triangle(triangle)
+        {
+            const size_t n = list.size();
+            this->setRows(n);
+            this->setCols(n);
+            this->setName(name);
+            m_packed.resize(detail::packedSize(n));
+
+            bool packed = true;
+            bool square = true;
+            size_t i = 0;
+            for (const auto& row : list) {
+                packed = packed && row.size() == (isLower() ? i + 1 : n - i);
+                square = square && row.size() == n;
+                i++;
+            }
+            if (!packed && !square) {
+                throw std::invalid_argument("Rows must form a square matrix or its triangle!");
+            }
+
+            i = 0;
+            for (const auto& row : list) {
+                size_t j = (packed && !isLower()) ? i : 0;
+                for (const auto& element : row) {
+                    if (contains(i, j)) {
+                        m_packed[index(i, j)] = element;
+                    } else if (element != static_cast<T>(0)) {
+                        throw std::invalid_argument("Matrix is not triangular!");
+                    }
+                    j++;
+                }
+                i++;
+            }
+        }
+
+        template <class T>
+        TriangularMatrix<T>::TriangularMatrix(size_t size, Triangle triangle, bool random, const std::string name)
+            : m_triangle(triangle)
+        {
+            this->setRows(size);
+            this->setCols(size);
+            this->setName(name);
+            m_packed.assign(detail::packedSize(size), static_cast<T>(0));
+
+            if (random) {
+                std::random_device rd;
+                std::mt19937 gen(rd());
+                detail::UniformElement<T> dis;
+                for (auto& element : m_packed) {
+                    element = dis(gen);
+                }
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    m_packed[index(i, i)] = static_cast<T>(1);
+                }
+            }
+        }
+
+        template <class T>
+        TriangularMatrix<T>::TriangularMatrix(const Matrix<T>& matrix, Triangle triangle, const std::string name)
+            : m_triangle(triangle)
+        {
+            if (matrix.getRows() != matrix.getCols()) {
+                throw std::invalid_argument("Triangular matrix must be square!");
+            }
+            const size_t n = matrix.getRows();
+            this->setRows(n);
+            this->setCols(n);
+            this->setName(name);
+            m_packed.resize(detail::packedSize(n));
+
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    if (contains(i, j)) {
+                        m_packed[index(i, j)] = matrix.getElement(i, j);
+                    }
+                }
+            }
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // TriangularMatrix class operators
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template <class T>
+        inline TriangularMatrix<T>& TriangularMatrix<T>::operator+=(const TriangularMatrix<T>& m1)
+        {
+            if (getRows() != m1.getRows() || m_triangle != m1.m_triangle) {
+                throw std::invalid_argument("Matrices must have the same dimensions and triangle.");
+            }
+            for (size_t i = 0; i < m_packed.size(); ++i) {
+                m_packed[i] += m1.m_packed[i];
+            }
+            return *this;
+        }
+
+        template <class T>
+        inline TriangularMatrix<T>& TriangularMatrix<T>::operator-=(const TriangularMatrix<T>& m1)
+        {
+            if (getRows() != m1.getRows() || m_triangle != m1.m_triangle) {
+                throw std::invalid_argument("Matrices must have the same dimensions and triangle.");
+            }
+            for (size_t i = 0; i < m_packed.size(); ++i) {
+                m_packed[i] -= m1.m_packed[i];
+            }
+            return *this;
+        }
+
+        template <class T>
+        inline TriangularMatrix<T>& TriangularMatrix<T>::operator*=(const T& scalar)
+        {
+            for (auto& element : m_packed) {
+                element *= scalar;
+            }
+            return *this;
+        }
+
+        template<class U>
+        inline std::ostream& operator<<(std::ostream& os, const TriangularMatrix<U>& m)
+        {
+            return os << m.toMatrix();
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // TriangularMatrix class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        template <class T>
+        inline bool TriangularMatrix<T>::contains(size_t row, size_t col) const
+        {
+            return isLower() ? col <= row : col >= row;
+        }
+
+        template <class T>
+        inline size_t TriangularMatrix<T>::index(size_t row, size_t col) const
+        {
+            const size_t n = getRows();
+            return isLower() ? row * (row + 1) / 2 + col
+                             : row * (2 * n - row + 1) / 2 + (col - row);
+        }
+
+        template <class T>
+        inline T TriangularMatrix<T>::getElement(size_t row, size_t col) const
+        {
+            if (row >= getRows() || col >= getCols()) {
+                throw std::out_of_range("Index out of range.");
+            }
+            return contains(row, col) ? m_packed[index(row, col)] : static_cast<T>(0);
+        }
+
+        template <class T>
+        inline void TriangularMatrix<T>::setElement(size_t row, size_t col, T element)
+        {
+            if (row >= getRows() || col >= getCols()) {
+                throw std::out_of_range("Index out of range.");
+            }
+            if (!contains(row, col)) {
+                throw std::invalid_argument("Element lies outside the stored triangle.");
+            }
+            m_packed[index(row, col)] = element;
+        }
+
+        template <class T>
+        inline Triangle TriangularMatrix<T>::getTriangle() const
+        {
+            return m_triangle;
+        }
+
+        template <class T>
+        inline bool TriangularMatrix<T>::isLower() const
+        {
+            return m_triangle == Triangle::Lower;
+        }
+
+        template <class T>
+        inline std::vector<T> TriangularMatrix<T>::getDiagonal() const
+        {
+            std::vector<T> diagonal(getRows());
+            for (size_t i = 0; i < getRows(); ++i) {
+                diagonal[i] = m_packed[index(i, i)];
+            }
+            return diagonal;
+        }
+
+        template <class T>
+        inline const std::vector<T>& TriangularMatrix<T>::getPacked() const
+        {
+            return m_packed;
+        }
+
+        template <class T>
+        inline Matrix<T> TriangularMatrix<T>::toMatrix() const
+        {
+            Matrix<T> result(getRows(), getCols(), zeroFill);
+            for (size_t i = 0; i < getRows(); ++i) {
+                for (size_t j = 0; j < getCols(); ++j) {
+                    result.getElement(i, j) = getElement(i, j);
+                }
+            }
+            return result;
+        }
+
+        template <class T>
+        inline void TriangularMatrix<T>::transpose()
+        {
+            const size_t n = getRows();
+            std::vector<T> transposed(m_packed.size());
+            const Triangle flipped = isLower() ? Triangle::Upper : Triangle::Lower;
+
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    if (contains(i, j)) {
+                        const size_t target = flipped == Triangle::Lower ? j * (j + 1) / 2 + i
+                                                                         : j * (2 * n - j + 1) / 2 + (i - j);
+                        transposed[target] = m_packed[index(i, j)];
+                    }
+                }
+            }
+            m_packed = std::move(transposed);
+            m_triangle = flipped;
+        }
+
+        template <class T>
+        template <class F>
+        inline auto TriangularMatrix<T>::withRows(F&& f) const
+        {
+            if (isLower()) {
+                return f(detail::PackedLowerRows<const T>{ m_packed.data() });
+            }
+            return f(detail::PackedUpperRows<const T>{ m_packed.data(), getRows() });
+        }
+
+
+        /**
+        * @brief Solves the triangular system this * x = b (TRSM).
+        * @param b Right-hand sides, one per column.
+        * @throws std::invalid_argument if matrices have incompatible dimensions.
+        * @throws std::runtime_error if the matrix is singular.
+        * @return The solution x.
+        * @tparam T Type of matrix elements.
+        */
+
+        template <class T>
+        inline Matrix<T> TriangularMatrix<T>::solve(const Matrix<T>& b) const
+        {
+            if (getRows() != b.getRows()) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the triangular matrix.");
+            }
+            std::vector<T> x = detail::pack(b);
+            withRows([&](auto rows) {
+                detail::trsmLeft(isLower(), false, getRows(), b.getCols(), rows, x.data(), b.getCols());
+            });
+            Matrix<T> result(b.getRows(), b.getCols(), zeroFill);
+            detail::unpack(x.data(), b.getCols(), result);
+            return result;
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // Triangular kernels and products
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Triangular solve (TRSM), returns x with t * x = b.
+        * @tparam T Type of matrix elements.
+        */
+
+        template<class T>
+        inline Matrix<T> trsm(const TriangularMatrix<T>& t, const Matrix<T>& b)
+        {
+            return t.solve(b);
+        }
+
+
+        /**
+        * @brief Multiplies a triangular matrix with a general matrix (TRMM).
+        * Only the stored triangle is read, which halves the work of the dense product.
+        * @throws std::invalid_argument if matrices have incompatible dimensions.
+        * @return Resultant matrix of the multiplication.
+        * @tparam U Type of matrix elements.
+        */
+
+        template<class U>
+        inline Matrix<U> operator*(const TriangularMatrix<U>& t, const Matrix<U>& m)
+        {
+            if (t.getCols() != m.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            Matrix<U> result(t.getRows(), m.getCols(), zeroFill);
+            std::vector<U> b = detail::pack(m);
+            std::vector<U> c(t.getRows() * m.getCols());
+            t.withRows([&](auto rows) {
+                detail::trmmLeft(t.isLower(), false, t.getRows(), m.getCols(), rows, b.data(), m.getCols(), c.data(), m.getCols());
+            });
+            detail::unpack(c.data(), m.getCols(), result);
+            return result;
+        }
+
+        template<class U>
+        inline Matrix<U> operator*(const Matrix<U>& m, const TriangularMatrix<U>& t)
+        {
+            if (m.getCols() != t.getRows()) {
+                throw std::invalid_argument("Number of columns in the first matrix must be equal to the number of rows in the second matrix.");
+            }
+            Matrix<U> result(m.getRows(), t.getCols(), zeroFill);
+            std::vector<U> b = detail::pack(m);
+            std::vector<U> c(m.getRows() * t.getCols());
+            t.withRows([&](auto rows) {
+                detail::trmmRight(t.isLower(), false, m.getRows(), t.getCols(), b.data(), m.getCols(), rows, c.data(), t.getCols());
+            });
+            detail::unpack(c.data(), t.getCols(), result);
+            return result;
+        }
+
+        template<class U>
+        inline Matrix<U> operator*(const TriangularMatrix<U>& t1, const TriangularMatrix<U>& t2)
+        {
+            return t1 * t2.toMatrix();
+        }
+
+        template<class U>
+        inline Matrix<U> operator*(const TriangularMatrix<U>& t, const SymmetricMatrix<U>& s)
+        {
+            return t * s.toMatrix();
+        }
+
+        template<class U>
+        inline Matrix<U> operator*(const SymmetricMatrix<U>& s, const TriangularMatrix<U>& t)
+        {
+            return s * t.toMatrix();
+        }
+
+        template<class U>
+        inline TriangularMatrix<U> operator*(const TriangularMatrix<U>& t, const U& scalar)
+        {
+            TriangularMatrix<U> result(t);
+            result *= scalar;
+            return result;
+        }
+
+        template<class U>
+        inline TriangularMatrix<U> operator*(const U& scalar, const TriangularMatrix<U>& t)
+        {
+            return t * scalar;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __TRIANGULARMATRIX_HPP__ */
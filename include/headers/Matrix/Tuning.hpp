@@ -0,0 +1,363 @@
+#ifndef __TUNING_HPP__
+#define __TUNING_HPP__
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+        * @brief Machine dependent blocking factors and serial / parallel cutoffs of the kernels.
+        * The defaults suit a typical x86 core with 32-48 KB L1d and 1-2 MB L2. autotune() measures
+        * better values for the current machine, saveTuning() stores them, and every process loads
+        * the stored values for its machine before the first kernel runs.
+        */
+        struct TuningParameters
+        {
+            size_t gemmBlockRows = 64;      // rows of A / C per GEMM block
+            size_t gemmBlockInner = 256;    // shared dimension per GEMM block
+            size_t gemmBlockCols = 256;     // cols of B / C per GEMM block
+            size_t gemmGrainRows = 64;      // minimum rows of C per thread in gemm()
+            size_t transposeTile = 32;      // square tile edge of the transpose kernels
+            size_t elementwiseGrain = 1 << 14; // minimum elements per thread of elementwise loops
+        };
+
+
+        namespace detail
+        {
+            struct TuningState
+            {
+                std::atomic<size_t> gemmBlockRows{ TuningParameters().gemmBlockRows };
+                std::atomic<size_t> gemmBlockInner{ TuningParameters().gemmBlockInner };
+                std::atomic<size_t> gemmBlockCols{ TuningParameters().gemmBlockCols };
+                std::atomic<size_t> gemmGrainRows{ TuningParameters().gemmGrainRows };
+                std::atomic<size_t> transposeTile{ TuningParameters().transposeTile };
+                std::atomic<size_t> elementwiseGrain{ TuningParameters().elementwiseGrain };
+            };
+
+            inline TuningState& tuningState()
+            {
+                static TuningState state;
+                return state;
+            }
+
+            inline void storeTuning(const TuningParameters& p)
+            {
+                TuningState& s = tuningState();
+                s.gemmBlockRows.store(p.gemmBlockRows, std::memory_order_relaxed);
+                s.gemmBlockInner.store(p.gemmBlockInner, std::memory_order_relaxed);
+                s.gemmBlockCols.store(p.gemmBlockCols, std::memory_order_relaxed);
+                s.gemmGrainRows.store(p.gemmGrainRows, std::memory_order_relaxed);
+                s.transposeTile.store(p.transposeTile, std::memory_order_relaxed);
+                s.elementwiseGrain.store(p.elementwiseGrain, std::memory_order_relaxed);
+            }
+
+            // Every field of the file, in the order it is written.
+            template<class F>
+            void forEachTuningField(TuningParameters& p, F&& f)
+            {
+                f("gemmBlockRows", p.gemmBlockRows);
+                f("gemmBlockInner", p.gemmBlockInner);
+                f("gemmBlockCols", p.gemmBlockCols);
+                f("gemmGrainRows", p.gemmGrainRows);
+                f("transposeTile", p.transposeTile);
+                f("elementwiseGrain", p.elementwiseGrain);
+            }
+
+            inline void checkTuning(const TuningParameters& p)
+            {
+                TuningParameters copy = p;
+                forEachTuningField(copy, [](const char* name, size_t value) {
+                    if (value == 0) {
+                        throw std::invalid_argument(std::string("Tuning parameter ") + name + " must be positive!");
+                    }
+                });
+            }
+
+            inline std::string trim(const std::string& s)
+            {
+                const size_t first = s.find_first_not_of(" \t\r");
+                if (first == std::string::npos) {
+                    return std::string();
+                }
+                return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+            }
+
+            inline std::string readFirstLine(const std::string& path)
+            {
+                std::ifstream file(path);
+                std::string line;
+                std::getline(file, line);
+                return trim(line);
+            }
+
+            inline std::string cpuModel()
+            {
+                std::ifstream cpuinfo("/proc/cpuinfo");
+                std::string line;
+                while (std::getline(cpuinfo, line)) {
+                    const size_t colon = line.find(':');
+                    if (colon == std::string::npos) {
+                        continue;
+                    }
+                    const std::string key = trim(line.substr(0, colon));
+                    if (key == "model name" || key == "Model" || key == "cpu model" || key == "Hardware") {
+                        return trim(line.substr(colon + 1));
+                    }
+                }
+                return "unknown cpu";
+            }
+
+            // "L1d=48K L1i=32K L2=2048K L3=36864K" from the sysfs cache description of cpu0.
+            inline std::string cacheSizes()
+            {
+                std::string sizes;
+                for (int index = 0; index < 16; ++index) {
+                    const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+                    const std::string level = readFirstLine(dir + "level");
+                    if (level.empty()) {
+                        break;
+                    }
+                    const std::string type = readFirstLine(dir + "type");
+                    const char* suffix = type == "Data" ? "d" : type == "Instruction" ? "i" : "";
+                    sizes += (sizes.empty() ? "" : " ") + ("L" + level) + suffix + "=" + readFirstLine(dir + "size");
+                }
+                return sizes.empty() ? "unknown caches" : sizes;
+            }
+
+            /**
+            * @brief Reads the entry of machine key from a tuning file into p.
+            * @return false if the file has no entry for the machine.
+            * @throws std::runtime_error if a value of the entry is malformed or zero.
+            */
+
+            inline bool parseTuning(std::istream& in, const std::string& key, TuningParameters& p)
+            {
+                std::string line;
+                bool inSection = false;
+                bool found = false;
+                while (std::getline(in, line)) {
+                    line = trim(line);
+                    if (line.empty() || line[0] == '#') {
+                        continue;
+                    }
+                    if (line.front() == '[' && line.back() == ']') {
+                        inSection = line.substr(1, line.size() - 2) == key;
+                        found = found || inSection;
+                        continue;
+                    }
+                    const size_t eq = line.find('=');
+                    if (!inSection || eq == std::string::npos) {
+                        continue;
+                    }
+                    const std::string name = trim(line.substr(0, eq));
+                    const std::string text = trim(line.substr(eq + 1));
+                    forEachTuningField(p, [&](const char* field, size_t& value) {
+                        if (name != field) {
+                            return;
+                        }
+                        size_t parsed = 0;
+                        std::istringstream number(text);
+                        if (!(number >> parsed) || parsed == 0) {
+                            throw std::runtime_error("Malformed tuning value for " + name + ".");
+                        }
+                        value = parsed;
+                    });
+                }
+                return found;
+            }
+
+        }; // end namespace detail
+
+
+        /**
+        * @brief Key of the tuning file entry of this machine: CPU model, cache sizes of cpu0 and
+        * number of hardware threads. Hosts of a mixed fleet sharing one file each get their own entry.
+        */
+
+        inline std::string machineKey()
+        {
+            return detail::cpuModel() + " | " + detail::cacheSizes() + " | threads=" + std::to_string(std::max(std::thread::hardware_concurrency(), 1u));
+        }
+
+        /**
+        * @brief Location of the tuning file: $NUMERICORE_TUNING_FILE if set (empty disables the
+        * file), otherwise $XDG_CONFIG_HOME/numericore/tuning.conf or ~/.config/numericore/tuning.conf.
+        */
+
+        inline std::string defaultTuningPath()
+        {
+            if (const char* path = std::getenv("NUMERICORE_TUNING_FILE")) {
+                return path;
+            }
+            if (const char* config = std::getenv("XDG_CONFIG_HOME"); config && *config) {
+                return std::string(config) + "/numericore/tuning.conf";
+            }
+            if (const char* home = std::getenv("HOME"); home && *home) {
+                return std::string(home) + "/.config/numericore/tuning.conf";
+            }
+            return std::string();
+        }
+
+
+        namespace detail
+        {
+            /**
+            * @brief Loads the stored entry of this machine once, before the first kernel reads the
+            * parameters or anyone sets them. A missing or malformed file leaves the defaults.
+            */
+
+            inline void ensureStartupTuning()
+            {
+                static const bool loaded = []() {
+                    try {
+                        const std::string path = defaultTuningPath();
+                        std::ifstream file(path);
+                        TuningParameters p;
+                        if (!path.empty() && file && parseTuning(file, machineKey(), p)) {
+                            storeTuning(p);
+                            return true;
+                        }
+                    }
+                    catch (const std::exception&) {
+                    }
+                    return false;
+                }();
+                (void)loaded;
+            }
+
+            /**
+            * @brief Parameters the kernels run with, read once per kernel call.
+            * Each field is a relaxed atomic, so setTuning() may race with running kernels; a
+            * kernel sees either the old or the new value of each field, never a torn one.
+            */
+
+            inline TuningParameters currentTuning()
+            {
+                ensureStartupTuning();
+                const TuningState& s = tuningState();
+                TuningParameters p;
+                p.gemmBlockRows = s.gemmBlockRows.load(std::memory_order_relaxed);
+                p.gemmBlockInner = s.gemmBlockInner.load(std::memory_order_relaxed);
+                p.gemmBlockCols = s.gemmBlockCols.load(std::memory_order_relaxed);
+                p.gemmGrainRows = s.gemmGrainRows.load(std::memory_order_relaxed);
+                p.transposeTile = s.transposeTile.load(std::memory_order_relaxed);
+                p.elementwiseGrain = s.elementwiseGrain.load(std::memory_order_relaxed);
+                return p;
+            }
+
+        }; // end namespace detail
+
+
+        inline TuningParameters getTuning()
+        {
+            return detail::currentTuning();
+        }
+
+        /**
+        * @brief Replaces the parameters of all kernels started from now on.
+        * @throws std::invalid_argument if a parameter is zero.
+        */
+
+        inline void setTuning(const TuningParameters& parameters)
+        {
+            detail::checkTuning(parameters);
+            detail::ensureStartupTuning();
+            detail::storeTuning(parameters);
+        }
+
+        /**
+        * @brief Applies the entry of this machine from a tuning file.
+        * @param path Tuning file, see defaultTuningPath().
+        * @return false if the file does not exist or has no entry for this machine.
+        * @throws std::runtime_error if the entry holds a malformed or zero value.
+        */
+
+        inline bool loadTuning(const std::string& path = defaultTuningPath())
+        {
+            std::ifstream file(path);
+            TuningParameters p;
+            if (path.empty() || !file || !detail::parseTuning(file, machineKey(), p)) {
+                return false;
+            }
+            setTuning(p);
+            return true;
+        }
+
+        /**
+        * @brief Writes the current parameters as the entry of this machine, replacing its previous
+        * entry and keeping those of other machines. The file is written to a temporary and renamed,
+        * so processes loading it concurrently never see a partial file.
+        * @param path Tuning file, see defaultTuningPath().
+        * @throws std::runtime_error if the file cannot be written.
+        */
+
+        inline void saveTuning(const std::string& path = defaultTuningPath())
+        {
+            if (path.empty()) {
+                throw std::runtime_error("No tuning file location, set NUMERICORE_TUNING_FILE or HOME.");
+            }
+            const std::string key = machineKey();
+
+            std::vector<std::string> kept;
+            {
+                std::ifstream file(path);
+                std::string line;
+                bool ours = false;
+                while (std::getline(file, line)) {
+                    const std::string t = detail::trim(line);
+                    if (!t.empty() && t.front() == '[' && t.back() == ']') {
+                        ours = t.substr(1, t.size() - 2) == key;
+                    }
+                    if (!ours) {
+                        kept.push_back(line);
+                    }
+                }
+            }
+            if (kept.empty()) {
+                kept.push_back("# NumeriCore kernel tuning, one entry per machine, written by saveTuning()");
+            }
+
+            std::error_code error;
+            const std::filesystem::path target(path);
+            if (target.has_parent_path()) {
+                std::filesystem::create_directories(target.parent_path(), error);
+            }
+            // A random suffix, thread ids and pids repeat across processes and hosts sharing the file.
+            const std::string temporary = path + ".tmp" + std::to_string(std::random_device()());
+            {
+                std::ofstream out(temporary, std::ios::trunc);
+                for (const auto& line : kept) {
+                    out << line << '\n';
+                }
+                out << '[' << key << "]\n";
+                TuningParameters p = getTuning();
+                detail::forEachTuningField(p, [&](const char* name, size_t value) {
+                    out << name << " = " << value << '\n';
+                });
+                if (!out.flush()) {
+                    throw std::runtime_error("Cannot write tuning file " + temporary + ".");
+                }
+            }
+            std::filesystem::rename(temporary, target, error);
+            if (error) {
+                std::filesystem::remove(temporary, error);
+                throw std::runtime_error("Cannot replace tuning file " + path + ".");
+            }
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __TUNING_HPP__ */
@@ -0,0 +1,177 @@
+#ifndef __WOODBURY_HPP__
+#define __WOODBURY_HPP__
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "LU.hpp"
+
+namespace NumeriCore
+{
+    namespace Matrix
+    {
+        /**
+         * @brief Explicit inverse of a matrix kept current under low-rank changes.
+         * After A becomes A + U * V^T the inverse is corrected by the Sherman-Morrison-Woodbury
+         * formula
+         *      (A + U V^T)^-1 = A^-1 - A^-1 U (I + V^T A^-1 U)^-1 V^T A^-1
+         * in O(n^2 k) for U, V of size n x k instead of O(n^3) for a new inverse. Rounding errors
+         * accumulate over many updates, construct a new object from the current matrix from time
+         * to time if that matters.
+         *
+         * Example usage:
+         * \code
+         * NumeriCore::Matrix::WoodburyInverse<double> inv(a);
+         * inv.update(u, v);        // a + u * v^T
+         * auto x = inv.solve(b);
+         * \endcode
+         */
+        template<class T>
+        class WoodburyInverse
+        {
+        public:
+            explicit WoodburyInverse(const Matrix<T>& a); // inverts a through an LU factorization
+
+            ~WoodburyInverse() = default;
+
+        public:
+            void update(const Matrix<T>& u, const Matrix<T>& v); // A becomes A + u * v^T
+            Matrix<T> solve(const Matrix<T>& b) const; // A^-1 * b
+            Matrix<T> getInverse() const; // A^-1
+            size_t getSize() const; // order of A
+
+        private:
+            size_t m_size = 0;
+            std::vector<T> m_inverse; // row-major
+        };
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // WoodburyInverse class c-tors and d-tors
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+         * @throw std::invalid_argument If a is not square.
+         * @throw std::runtime_error If a is singular.
+         */
+
+        template<class T>
+        WoodburyInverse<T>::WoodburyInverse(const Matrix<T>& a)
+            : m_size(a.getRows())
+            , m_inverse(detail::pack(LU<T>(a).inverse()))
+        {
+        }
+
+
+        // ///////////////////////////////////////////////////////////////////////////////////////////
+        // WoodburyInverse class methodes
+        // //////////////////////////////////////////////////////////////////////////////////////////
+
+        /**
+        * @brief Applies A + u * v^T to the maintained inverse.
+        * W = A^-1 U and Z = V^T A^-1 are two GEMMs, the k x k capacitance system
+        * (I + V^T W) Y = Z is solved by LU and A^-1 -= W Y is a third GEMM.
+        *
+        * @param u Left factor, n x k.
+        * @param v Right factor, n x k.
+        * @throw std::invalid_argument If u and v are not both n x k.
+        * @throw std::runtime_error If A + u * v^T is singular, the inverse is left unchanged.
+        */
+
+        template<class T>
+        void WoodburyInverse<T>::update(const Matrix<T>& u, const Matrix<T>& v)
+        {
+            if (u.getRows() != m_size || v.getRows() != m_size || u.getCols() != v.getCols()) {
+                throw std::invalid_argument("Update factors must both be n x k!");
+            }
+            const size_t n = m_size;
+            const size_t k = u.getCols();
+            if (k == 0) {
+                return;
+            }
+            const std::vector<T> packedU = detail::pack(u);
+            std::vector<T> vt(k * n);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t p = 0; p < k; ++p) {
+                    vt[p * n + i] = v.rowData(i)[p];
+                }
+            }
+            const T* inverse = m_inverse.data();
+
+            std::vector<T> w(n * k);
+            detail::parallelFor(0, n, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::gemm(hi - lo, k, n, inverse + lo * n, n, packedU.data(), k, w.data() + lo * k, k);
+            });
+            std::vector<T> zBuffer(k * n);
+            detail::parallelFor(0, n, detail::currentTuning().gemmBlockCols, [&](size_t lo, size_t hi) {
+                detail::gemm(k, hi - lo, n, vt.data(), n, inverse + lo, n, zBuffer.data() + lo, n);
+            });
+            Matrix<T> z(k, n, zeroFill);
+            detail::unpack(zBuffer.data(), n, z);
+
+            std::vector<T> capacitance(k * k);
+            detail::gemm(k, k, n, vt.data(), n, w.data(), k, capacitance.data(), k);
+            for (size_t p = 0; p < k; ++p) {
+                capacitance[p * k + p] += static_cast<T>(1);
+            }
+            Matrix<T> c(k, k, zeroFill);
+            detail::unpack(capacitance.data(), k, c);
+
+            std::vector<T> y;
+            try {
+                y = detail::pack(LU<T>(c).solve(z));
+            }
+            catch (const std::runtime_error&) {
+                throw std::runtime_error("Update makes the matrix singular.");
+            }
+
+            for (auto& value : w) {
+                value = -value;
+            }
+            detail::parallelFor(0, n, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::gemm(hi - lo, n, k, w.data() + lo * k, k, y.data(), n, m_inverse.data() + lo * n, n, true);
+            });
+        }
+
+        /**
+        * @throws std::invalid_argument if b has the wrong number of rows.
+        */
+
+        template<class T>
+        Matrix<T> WoodburyInverse<T>::solve(const Matrix<T>& b) const
+        {
+            if (b.getRows() != m_size) {
+                throw std::invalid_argument("Number of rows of the right-hand side must match the inverted matrix.");
+            }
+            const size_t r = b.getCols();
+            const std::vector<T> packedB = detail::pack(b);
+            std::vector<T> x(m_size * r);
+            detail::parallelFor(0, m_size, detail::currentTuning().gemmGrainRows, [&](size_t lo, size_t hi) {
+                detail::gemm(hi - lo, r, m_size, m_inverse.data() + lo * m_size, m_size, packedB.data(), r, x.data() + lo * r, r);
+            });
+            Matrix<T> result(m_size, r, zeroFill);
+            detail::unpack(x.data(), r, result);
+            return result;
+        }
+
+        template<class T>
+        Matrix<T> WoodburyInverse<T>::getInverse() const
+        {
+            Matrix<T> result(m_size, m_size, zeroFill);
+            detail::unpack(m_inverse.data(), m_size, result);
+            return result;
+        }
+
+        template<class T>
+        size_t WoodburyInverse<T>::getSize() const
+        {
+            return m_size;
+        }
+
+    }; // end namespace Matrix
+}; // end namespace NumeriCore
+
+#endif /* __WOODBURY_HPP__ */
@@ -0,0 +1,220 @@
+// Low-rank updates of the factorizations checked against fresh factorizations of the updated
+// matrix, including the LU fallback to refactoring and the failing Cholesky downdate.
+//
+// g++ -O2 -std=c++17 -pthread tests/UpdateRoutines.cpp -o update_routines
+// ./update_routines
+
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include "../include/NumeriCore.hpp"
+
+
+namespace
+{
+    using NumeriCore::Matrix::Matrix;
+
+    int failures = 0;
+
+    void check(bool passed, const std::string& what)
+    {
+        std::cout << (passed ? "pass  " : "FAIL  ") << what << std::endl;
+        failures += passed ? 0 : 1;
+    }
+
+    double maxDifference(const Matrix<double>& a, const Matrix<double>& b)
+    {
+        double result = 0;
+        for (size_t i = 0; i < a.getRows(); ++i) {
+            for (size_t j = 0; j < a.getCols(); ++j) {
+                result = std::max(result, std::abs(a.getElement(i, j) - b.getElement(i, j)));
+            }
+        }
+        return result;
+    }
+
+    // Random matrix with elements in [-0.4, 1], the constructor draws them from [-2000, 5000].
+    Matrix<double> random(size_t rows, size_t cols)
+    {
+        Matrix<double> result(rows, cols);
+        return result * (1.0 / 5000.0);
+    }
+
+    Matrix<double> identity(size_t n)
+    {
+        Matrix<double> result(n, n, NumeriCore::Matrix::zeroFill);
+        for (size_t i = 0; i < n; ++i) {
+            result.getElement(i, i) = 1.0;
+        }
+        return result;
+    }
+
+    // Random matrix made well conditioned by a dominant diagonal.
+    Matrix<double> dominant(size_t n)
+    {
+        Matrix<double> result = random(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            result.getElement(i, i) += static_cast<double>(n);
+        }
+        return result;
+    }
+
+    // Random symmetric positive definite matrix.
+    Matrix<double> spd(size_t n)
+    {
+        Matrix<double> b = random(n, n);
+        Matrix<double> bt = b;
+        bt.transpose();
+        Matrix<double> result = b * bt;
+        for (size_t i = 0; i < n; ++i) {
+            result.getElement(i, i) += static_cast<double>(n);
+        }
+        return result;
+    }
+
+    // a + u * v^T
+    Matrix<double> plusOuter(const Matrix<double>& a, const Matrix<double>& u, const Matrix<double>& v)
+    {
+        Matrix<double> vt = v;
+        vt.transpose();
+        return a + u * vt;
+    }
+
+    // Scaled down so the rank-k term leaves the matrix safely positive definite.
+    Matrix<double> small(size_t rows, size_t cols)
+    {
+        return random(rows, cols) * 0.1;
+    }
+
+    void luUpdate()
+    {
+        const size_t n = 40;
+        const double tolerance = 1e-9;
+        Matrix<double> a = dominant(n);
+        Matrix<double> u = random(n, 3);
+        Matrix<double> v = random(n, 3);
+        Matrix<double> b = random(n, 2);
+
+        NumeriCore::Matrix::LU<double> lu(a);
+        const bool cheap = lu.update(u, v);
+        const Matrix<double> updated = plusOuter(a, u, v);
+        NumeriCore::Matrix::LU<double> fresh(updated);
+
+        check(cheap, "LU::update takes the O(n^2 k) path on a dominant matrix");
+        check(maxDifference(lu.solve(b), fresh.solve(b)) < tolerance, "LU::update solves like a fresh factorization");
+        check(std::abs(lu.determinant() - fresh.determinant()) < tolerance * std::abs(fresh.determinant()), "LU::update keeps the determinant of a fresh factorization");
+    }
+
+    void luFallback()
+    {
+        // I + u v^T swaps the first two rows, so the kept pivot order meets a zero pivot.
+        const size_t n = 6;
+        Matrix<double> a = identity(n);
+        Matrix<double> u(n, 1, NumeriCore::Matrix::zeroFill);
+        Matrix<double> v(n, 1, NumeriCore::Matrix::zeroFill);
+        u.getElement(0, 0) = -1.0;
+        u.getElement(1, 0) = 1.0;
+        v.getElement(0, 0) = 1.0;
+        v.getElement(1, 0) = -1.0;
+        Matrix<double> b = random(n, 2);
+
+        NumeriCore::Matrix::LU<double> lu(a);
+        const bool cheap = lu.update(u, v);
+        NumeriCore::Matrix::LU<double> fresh(plusOuter(a, u, v));
+
+        check(!cheap, "LU::update returns false when it has to refactor");
+        check(maxDifference(lu.solve(b), fresh.solve(b)) < 1e-12, "LU::update fallback solves like a fresh factorization");
+        check(std::abs(lu.determinant() + 1.0) < 1e-12, "LU::update fallback has the determinant of the swap");
+
+        // u v^T = -e0 e0^T makes the matrix singular, the factorization of A must survive.
+        Matrix<double> e0(n, 1, NumeriCore::Matrix::zeroFill);
+        e0.getElement(0, 0) = 1.0;
+        Matrix<double> minusE0 = e0 * -1.0;
+        NumeriCore::Matrix::LU<double> kept(a);
+        bool threw = false;
+        try {
+            kept.update(minusE0, e0);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        check(threw, "LU::update throws when the updated matrix is singular");
+        check(maxDifference(kept.solve(b), b) < 1e-12, "LU::update keeps the factorization after throwing");
+    }
+
+    void choleskyUpdate()
+    {
+        const size_t n = 40;
+        const double tolerance = 1e-9;
+        Matrix<double> a = spd(n);
+        Matrix<double> x = small(n, 3);
+        Matrix<double> b = random(n, 2);
+
+        NumeriCore::Matrix::Cholesky<double> up(a);
+        up.update(x);
+        NumeriCore::Matrix::Cholesky<double> freshUp(plusOuter(a, x, x));
+        check(maxDifference(up.getL().toMatrix(), freshUp.getL().toMatrix()) < tolerance, "Cholesky::update matches the factor of A + x x^T");
+        check(maxDifference(up.solve(b), freshUp.solve(b)) < tolerance, "Cholesky::update solves like a fresh factorization");
+
+        NumeriCore::Matrix::Cholesky<double> down(a);
+        down.downdate(x);
+        NumeriCore::Matrix::Cholesky<double> freshDown(plusOuter(a, x * -1.0, x));
+        check(maxDifference(down.getL().toMatrix(), freshDown.getL().toMatrix()) < tolerance, "Cholesky::downdate matches the factor of A - x x^T");
+        check(std::abs(down.logDeterminant() - freshDown.logDeterminant()) < tolerance, "Cholesky::downdate keeps the log determinant of a fresh factorization");
+
+        up.downdate(x);
+        NumeriCore::Matrix::Cholesky<double> original(a);
+        check(maxDifference(up.getL().toMatrix(), original.getL().toMatrix()) < tolerance, "Cholesky::downdate undoes Cholesky::update");
+    }
+
+    void choleskyFailingDowndate()
+    {
+        // I - x x^T with x = 2 e0 has the eigenvalue -3.
+        const size_t n = 5;
+        Matrix<double> x(n, 1, NumeriCore::Matrix::zeroFill);
+        x.getElement(0, 0) = 2.0;
+        Matrix<double> b = random(n, 2);
+
+        NumeriCore::Matrix::Cholesky<double> chol(identity(n));
+        bool threw = false;
+        try {
+            chol.downdate(x);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        check(threw, "Cholesky::downdate throws when A - x x^T is indefinite");
+        check(maxDifference(chol.solve(b), b) < 1e-12, "Cholesky::downdate keeps the factorization after throwing");
+    }
+
+    void woodburyUpdate()
+    {
+        const size_t n = 40;
+        const double tolerance = 1e-9;
+        Matrix<double> a = dominant(n);
+        Matrix<double> u = random(n, 4);
+        Matrix<double> v = random(n, 4);
+        Matrix<double> b = random(n, 2);
+
+        NumeriCore::Matrix::WoodburyInverse<double> inverse(a);
+        inverse.update(u, v);
+        NumeriCore::Matrix::LU<double> fresh(plusOuter(a, u, v));
+        check(maxDifference(inverse.getInverse(), fresh.inverse()) < tolerance, "WoodburyInverse::update matches a fresh inverse");
+        check(maxDifference(inverse.solve(b), fresh.solve(b)) < tolerance, "WoodburyInverse::update solves like a fresh factorization");
+    }
+}
+
+
+int main()
+{
+    luUpdate();
+    luFallback();
+    choleskyUpdate();
+    choleskyFailingDowndate();
+    woodburyUpdate();
+
+    std::cout << (failures == 0 ? "all passed" : std::to_string(failures) + " failed") << "\n";
+    return failures == 0 ? 0 : 1;
+}